@@ -0,0 +1,151 @@
+/**
+ * @file bench.hpp
+ * @author radj307
+ * @brief Minimal, portable benchmark harness that reports the time, number of allocations & number of allocated bytes per operation.
+ *\n	  Allocations & live heap bytes are counted by the global operator new & delete replacements from instrument-allocations.hpp,
+ *\n	  which are defined by defining BENCH_DEFINE_ALLOCATION_HOOKS before including this header first in exactly one translation unit.
+ *\n	  Hardware counters are also read around each measured batch after calling enable_counters(), see perf-counters.hpp.
+ */
+#pragma once
+#if defined(BENCH_DEFINE_ALLOCATION_HOOKS) && !defined(OPT_DEFINE_ALLOCATION_HOOKS)
+#define OPT_DEFINE_ALLOCATION_HOOKS
+#endif
+#include <instrument-allocations.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "perf-counters.hpp"
+
+namespace bench {
+	inline std::atomic<uint64_t>& allocation_count{ opt::instrument::heap_totals.allocations };	///< @brief Number of calls to operator new since the program started.
+	inline std::atomic<uint64_t>& allocation_bytes{ opt::instrument::heap_totals.bytes };		///< @brief Number of bytes requested from operator new since the program started.
+	inline std::atomic<int64_t>& live_bytes{ opt::instrument::heap_totals.live };				///< @brief Number of bytes allocated by operator new that haven't been deleted yet.
+	inline std::unique_ptr<PerfCounters> perf_counters;		///< @brief Hardware counters read by run(), or nullptr when they are disabled.
+
+	/**
+	 * @brief Read hardware counters around each benchmark from now on. A warning is printed to stderr for each counter that is unavailable.
+	 * @returns bool	- false when no counters are available, in which case benchmarks are run without them.
+	 */
+	inline bool enable_counters()
+	{
+		perf_counters = std::make_unique<PerfCounters>();
+		if (!perf_counters->available()) {
+			std::fprintf(stderr, "Hardware counters are unavailable, continuing without them: %s\n", perf_counters->error().c_str());
+			perf_counters.reset();
+			return false;
+		}
+		for (size_t i{ 0u }; i < COUNTER_COUNT; ++i)
+			if (!perf_counters->available(static_cast<Counter>(i)))
+				std::fprintf(stderr, "The %s counter is unavailable: %s\n", std::string{ get_countername(static_cast<Counter>(i)) }.c_str(), perf_counters->error(static_cast<Counter>(i)).c_str());
+		return true;
+	}
+
+	/**
+	 * @brief Prevent the compiler from optimizing away the calculation of a value.
+	 * @param value	- Any value.
+	 */
+	template<class T>
+	inline void do_not_optimize(const T& value)
+	{
+	#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+	#else
+		static volatile const void* sink;
+		sink = &value;
+	#endif
+	}
+
+	/**
+	 * @struct Result
+	 * @brief The measurements of a single benchmark.
+	 */
+	struct Result {
+		std::string name;			///< @brief Name of the benchmark.
+		size_t n;					///< @brief Size of the input, usually the number of arguments.
+		uint64_t iterations;		///< @brief Number of times the benchmark was run during the measured batch.
+		double ns_per_op;			///< @brief Average time per iteration, in nanoseconds.
+		double allocs_per_op;		///< @brief Average number of allocations per iteration.
+		double bytes_per_op;		///< @brief Average number of allocated bytes per iteration.
+		std::array<std::optional<double>, COUNTER_COUNT> counters_per_op{};	///< @brief Average number of each hardware event per iteration, when counters are enabled & available.
+	};
+
+	/**
+	 * @brief Run a benchmark, doubling the number of iterations until a batch takes at least min_time.
+	 * @param name		- Name of the benchmark.
+	 * @param n			- Size of the input.
+	 * @param fn		- Function to measure. It is called once per iteration with no arguments.
+	 * @param min_time	- Minimum duration of the measured batch.
+	 * @returns Result	- The measurements of the last batch.
+	 */
+	template<class Fn>
+	inline Result run(std::string name, const size_t n, Fn&& fn, const std::chrono::nanoseconds min_time = std::chrono::milliseconds(100))
+	{
+		using clock = std::chrono::steady_clock;
+		for (uint64_t iterations{ 1u }; ; iterations *= 2u) {
+			const auto allocs{ allocation_count.load(std::memory_order_relaxed) }, bytes{ allocation_bytes.load(std::memory_order_relaxed) };
+			if (perf_counters)
+				perf_counters->start();
+			const auto start{ clock::now() };
+			for (uint64_t i{ 0u }; i < iterations; ++i)
+				fn();
+			const auto elapsed{ clock::now() - start };
+			const auto counters{ perf_counters ? perf_counters->stop() : CounterValues{} };
+			if (elapsed >= min_time || iterations >= (uint64_t{ 1u } << 40u)) {
+				const auto count{ static_cast<double>(iterations) };
+				Result result{
+					std::move(name),
+					n,
+					iterations,
+					static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / count,
+					static_cast<double>(allocation_count.load(std::memory_order_relaxed) - allocs) / count,
+					static_cast<double>(allocation_bytes.load(std::memory_order_relaxed) - bytes) / count,
+				};
+				for (size_t i{ 0u }; i < COUNTER_COUNT; ++i)
+					if (counters[i].has_value())
+						result.counters_per_op[i] = static_cast<double>(counters[i].value()) / count;
+				return result;
+			}
+		}
+	}
+
+	/// @brief Print the column headers used by print(). The hardware counter columns are only printed when counters are enabled.
+	inline void print_header()
+	{
+		std::printf("%-40s %10s %12s %14s %12s %14s", "benchmark", "n", "iterations", "ns/op", "allocs/op", "bytes/op");
+		if (perf_counters)
+			std::printf(" %14s %14s %6s %14s %14s %14s", "cycles/op", "instr/op", "IPC", "L1d-miss/op", "LLC-miss/op", "br-miss/op");
+		std::printf("\n");
+	}
+	/**
+	 * @brief Print a benchmark result as a row of a table.
+	 * @param result	- Result to print.
+	 */
+	inline void print(const Result& result)
+	{
+		std::printf("%-40s %10zu %12llu %14.1f %12.2f %14.1f", result.name.c_str(), result.n, static_cast<unsigned long long>(result.iterations), result.ns_per_op, result.allocs_per_op, result.bytes_per_op);
+		if (perf_counters) {
+			const auto column{ [](const std::optional<double>& value, const int width = 14, const int precision = 1) {
+				if (value.has_value())
+					std::printf(" %*.*f", width, precision, value.value());
+				else std::printf(" %*s", width, "-");
+			} };
+			const auto& counters{ result.counters_per_op };
+			const auto cycles{ counters[static_cast<size_t>(Counter::CYCLES)] }, instructions{ counters[static_cast<size_t>(Counter::INSTRUCTIONS)] };
+			column(cycles);
+			column(instructions);
+			column(cycles.has_value() && instructions.has_value() && cycles.value() > 0.0 ? std::optional<double>{ instructions.value() / cycles.value() } : std::nullopt, 6, 2);
+			column(counters[static_cast<size_t>(Counter::L1D_MISSES)]);
+			column(counters[static_cast<size_t>(Counter::LLC_MISSES)]);
+			column(counters[static_cast<size_t>(Counter::BRANCH_MISSES)]);
+		}
+		std::printf("\n");
+		std::fflush(stdout);
+	}
+}
\ No newline at end of file
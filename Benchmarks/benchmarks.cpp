@@ -0,0 +1,105 @@
+/**
+ * @file benchmarks.cpp
+ * @author radj307
+ * @brief Benchmarks parseArgs, Params & ParamsAPI over commandlines with 10 to 10^6 arguments. See the README for build instructions.
+ *\n_USAGE:_
+ *\n	benchmarks [--max <N>] [--min-time <ms>] [--filter <substring>] [--shape <name|all>] [--seed <N>] [--replay <file>] [--counters]
+ *\n	--max		Largest number of arguments to benchmark. (Default: 1000000)
+ *\n	--min-time	Minimum duration of each measured batch, in milliseconds. (Default: 100)
+ *\n	--filter	Only run benchmarks whose name contains this string.
+ *\n	--shape		Shape of the generated commandlines, see corpus::Shape. (Default: mixed)
+ *\n	--seed		Random seed used to generate commandlines. (Default: 0)
+ *\n	--replay	Benchmark the commandlines recorded in a file instead of generated ones, see corpus::load().
+ *\n	--counters	Also report hardware counters for each operation, see perf-counters.hpp. Benchmarks run without them if the kernel disallows access.
+ */
+#define BENCH_DEFINE_ALLOCATION_HOOKS
+#include "bench.hpp"
+#include <Params.hpp>
+#include <ParamsAPI.hpp>
+#include "corpus.hpp"
+
+namespace {
+	/**
+	 * @brief Discards everything written to it, so that operator<< can be measured without the cost of storing the output.
+	 */
+	struct NullBuffer : std::streambuf {
+		int overflow(const int ch) override { return ch; }
+		std::streamsize xsputn(const char*, const std::streamsize count) override { return count; }
+	};
+
+	const opt::ParserConfig config{ corpus::capture_list() };
+
+	/**
+	 * @brief Run every benchmark on a single commandline.
+	 * @param run			- Function that runs & prints a benchmark.
+	 * @param label			- Prefix added to each benchmark name.
+	 * @param commandline	- Commandline to benchmark.
+	 */
+	template<class RunFn>
+	void run_suite(RunFn&& run, const std::string& label, const std::vector<std::string>& commandline)
+	{
+		const auto n{ commandline.size() };
+		const auto cont{ opt::parseArgs(commandline, config) };
+		const opt::Params params{ cont };
+		const opt::ParamsAPI api{ opt::ContainerType{ cont } };
+
+		// query targets near the middle of the commandline, so that linear searches do a representative amount of work
+		std::string hit, missing{ "not-present" };
+		for (auto it{ cont.begin() + static_cast<ptrdiff_t>(cont.size() / 2u) }; it != cont.end() && hit.empty(); ++it)
+			if (it->type() == opt::Type::OPTION)
+				hit = it->name();
+		if (hit.empty())
+			hit = "output";
+
+		run(label + "parseArgs", n, [&]() { bench::do_not_optimize(opt::parseArgs(commandline, config)); });
+
+		run(label + "Params::find (hit)", n, [&]() { bench::do_not_optimize(params.find(hit)); });
+		run(label + "Params::find (miss)", n, [&]() { bench::do_not_optimize(params.find(missing)); });
+		run(label + "Params::check", n, [&]() { bench::do_not_optimize(params.check(hit)); });
+		run(label + "Params::getv", n, [&]() { bench::do_not_optimize(params.getv("output")); });
+		run(label + "Params::getAllWithType<Option>", n, [&]() { bench::do_not_optimize(params.getAllWithType<opt::Option>()); });
+
+		run(label + "ParamsAPI::find (hit)", n, [&]() { bench::do_not_optimize(api.find(hit)); });
+		run(label + "ParamsAPI::find (miss)", n, [&]() { bench::do_not_optimize(api.find(missing)); });
+		run(label + "ParamsAPI::check", n, [&]() { bench::do_not_optimize(api.check(hit)); });
+		run(label + "ParamsAPI::getv", n, [&]() { bench::do_not_optimize(api.getv("output")); });
+		run(label + "ParamsAPI::getAllWithType<Option>", n, [&]() { bench::do_not_optimize(api.getAllWithType<opt::Option, std::vector<opt::Option>>()); });
+
+		NullBuffer null_buffer;
+		std::ostream null_stream{ &null_buffer };
+		run(label + "Params::operator<<", n, [&]() { null_stream << params; });
+		run(label + "ParamsAPI::operator<<", n, [&]() { null_stream << api; });
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const opt::ParamsAPI args{ argc, argv, "max", "min-time", "filter", "shape", "seed", "replay" };
+	const auto max{ std::stoull(args.getv("max").value_or("1000000")) };
+	const std::chrono::milliseconds min_time{ std::stoll(args.getv("min-time").value_or("100")) };
+	const auto filter{ args.getv("filter").value_or("") };
+	const auto shape_name{ args.getv("shape").value_or("mixed") };
+	const auto seed{ std::stoull(args.getv("seed").value_or("0")) };
+	if (args.check_opt("counters"))
+		bench::enable_counters();
+
+	const auto run{ [&](const std::string& name, const size_t n, auto&& fn) {
+		if (name.find(filter) != std::string::npos)
+			bench::print(bench::run(name, n, fn, min_time));
+	} };
+
+	bench::print_header();
+	if (const auto replay{ args.getv("replay") }; replay.has_value()) {
+		const auto commandlines{ corpus::load(replay.value()) };
+		for (size_t i{ 0u }; i < commandlines.size(); ++i)
+			run_suite(run, "[replay " + std::to_string(i) + "] ", commandlines[i]);
+		return 0;
+	}
+	for (const auto shape : corpus::ALL_SHAPES) {
+		if (shape_name != "all" && shape_name != corpus::get_shapename(shape))
+			continue;
+		for (size_t n{ 10u }; n <= max; n *= 10u)
+			run_suite(run, '[' + std::string{ corpus::get_shapename(shape) } + "] ", corpus::generate(shape, n, seed));
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,317 @@
+/**
+ * @file complexity.cpp
+ * @author radj307
+ * @brief Measures every public entry point on worst-case inputs of doubling size, & fits the scaling curve to verify that each one is linear.
+ *\n	  The exponent of the curve is the slope of a least-squares line through (log n, log ns/op). A linear entry point has a slope of 1,
+ *\n	  an O(1) query has a slope of 0, & a quadratic path has a slope of 2.
+ *\n	  Linear paths fit slightly above 1, because larger inputs no longer fit in the CPU caches & their allocations are returned to the OS,
+ *\n	  so the default limit is set between that & the slope of 2 that a quadratic path produces.
+ *\n	  Each case also has a budget for the time per unit of input, which is checked at the largest size. Budgets are multiples of the time per byte
+ *\n	  of a reference case that copies a commandline, which is measured first, so that they hold on faster & slower machines alike.
+ *\n	  Every size is measured several times & the fastest batch is kept, which removes most of the noise caused by other processes.
+ *\n	  The program exits with 1 when any case exceeds --max-slope or its budget, so that it can fail a build.
+ *\n_USAGE:_
+ *\n	complexity [--min-size <N>] [--max-size <N>] [--min-time <ms>] [--repeat <N>] [--max-slope <X>] [--filter <substring>]
+ *\n	--min-size	Smallest input size. (Default: 4096)
+ *\n	--max-size	Largest input size. (Default: 262144)
+ *\n	--min-time	Minimum duration of each measured batch, in milliseconds. (Default: 20)
+ *\n	--repeat	Number of batches measured for each size. (Default: 3)
+ *\n	--max-slope	Largest accepted exponent for a linear case. Constant cases accept this minus 1. (Default: 1.5)
+ *\n	--filter	Only run cases whose name contains this string.
+ */
+#define BENCH_DEFINE_ALLOCATION_HOOKS
+#include "bench.hpp"
+#include <Params.hpp>
+#include <ParamsAPI.hpp>
+#include <CStringArray.hpp>
+#include <EnvBuilder.hpp>
+#include <canonicalize-args.hpp>
+#include <diffArgs.hpp>
+#include <parseCmdline.hpp>
+#include <parseResponseFile.hpp>
+#include <render-argv.hpp>
+#include <serialize-args.hpp>
+#include <cmath>
+#include <functional>
+
+namespace {
+	/// @brief Options that capture the following argument in every case that parses.
+	const opt::ParserConfig config{ { "output", "config", "o", "c" } };
+
+	/**
+	 * @struct Case
+	 * @brief A worst-case input for one entry point.
+	 */
+	struct Case {
+		std::string name;		///< @brief Name of the case.
+		std::string unit;		///< @brief What the size of the input counts. (bytes, args, vars)
+		double budget;			///< @brief Largest accepted time per unit of input at the largest size, as a multiple of the reference's time per byte. For constant cases, this is the time per operation instead.
+		bool constant{ false };	///< @brief When true, the case is expected to be O(1) in the size of the input rather than O(n).
+		/// @brief Builds an input of the given size, & returns a function that runs the entry point on it once.
+		std::function<std::function<void()>(size_t)> prepare;
+	};
+
+	/// @brief Generates n distinct names, such as "name0", "name1", ...
+	std::vector<std::string> names(const size_t n, const std::string& prefix)
+	{
+		std::vector<std::string> vec;
+		vec.reserve(n);
+		for (size_t i{ 0u }; i < n; ++i)
+			vec.emplace_back(prefix + std::to_string(i));
+		return vec;
+	}
+
+	/// @brief Parses a commandline that has n arguments with the same name, which are queried repeatedly by the find cases.
+	opt::ContainerType repeated_options(const size_t n)
+	{
+		std::vector<std::string> vec;
+		vec.reserve(n);
+		for (size_t i{ 0u }; i < n; ++i)
+			vec.emplace_back("--opt" + std::to_string(i % 64u));
+		return opt::parseArgs(vec, config);
+	}
+
+	/// @brief Parses a commandline of n arguments that contains every argument type.
+	opt::ContainerType mixed(const size_t n, const size_t variant = 0u)
+	{
+		std::vector<std::string> vec;
+		vec.reserve(n);
+		for (size_t i{ 0u }; vec.size() < n; ++i) {
+			switch ((i + variant) % 5u) {
+			case 0u:
+				vec.emplace_back("-abc");
+				break;
+			case 1u:
+				vec.emplace_back("--opt" + std::to_string(i % 97u));
+				break;
+			case 2u:
+				vec.emplace_back("--output");
+				vec.emplace_back("value" + std::to_string(i));
+				break;
+			case 3u:
+				vec.emplace_back("-" + std::to_string(i));
+				break;
+			default:
+				vec.emplace_back("file" + std::to_string(i));
+				break;
+			}
+		}
+		return opt::parseArgs(vec, config);
+	}
+
+	/**
+	 * @brief Returns a function that runs parseArgs on a commandline.
+	 * @param vec	- Commandline. Its size in bytes should be approximately the requested input size.
+	 */
+	std::function<void()> parse(std::vector<std::string> vec)
+	{
+		return [vec = std::move(vec)]() { bench::do_not_optimize(opt::parseArgs(vec, config)); };
+	}
+
+	/// @brief The case that budgets are relative to, which copies a commandline of short strings & so measures the CPU, memory & allocator without this library.
+	Case make_reference()
+	{
+		return{ "reference (copy strings)", "bytes", 1.0, false, [](const size_t n) {
+			auto vec{ std::make_shared<std::vector<std::string>>(names(n / 8u, "arg")) };
+			return [vec]() { bench::do_not_optimize(std::vector<std::string>{ *vec }); };
+		} };
+	}
+
+	std::vector<Case> make_cases()
+	{
+		std::vector<Case> cases;
+		// a single flag cluster, which calls allowCapture for every character
+		cases.push_back({ "parseArgs (flag cluster)", "bytes", 75.0, false, [](const size_t n) {
+			return parse({ '-' + std::string(n, 'a') });
+		} });
+		// a single flag cluster that ends with a capturing flag
+		cases.push_back({ "parseArgs (capturing cluster)", "bytes", 300.0, false, [](const size_t n) {
+			return parse({ '-' + std::string(n, 'a') + 'o', "value" });
+		} });
+		// one very long option name, which is compared against every capture
+		cases.push_back({ "parseArgs (long option)", "bytes", 25.0, false, [](const size_t n) {
+			return parse({ "--" + std::string(n, 'x') });
+		} });
+		cases.push_back({ "parseArgs (many options)", "bytes", 50.0, false, [](const size_t n) {
+			auto vec{ names(n / 8u, "--opt") };
+			return parse(std::move(vec));
+		} });
+		// negative numbers must be distinguished from flags by scanning every character
+		cases.push_back({ "parseArgs (negative numbers)", "bytes", 50.0, false, [](const size_t n) {
+			std::vector<std::string> vec{ "-" + std::string(n / 2u, '9'), "-" + std::string(n / 4u, '1') + '.' + std::string(n / 4u, '5') };
+			for (size_t i{ 0u }; i < n / 32u; ++i)
+				vec.emplace_back("-1234567.890");
+			return parse(std::move(vec));
+		} });
+		// every argument is a capturing option, so each one captures the next
+		cases.push_back({ "parseArgs (capture chain)", "bytes", 50.0, false, [](const size_t n) {
+			return parse(std::vector<std::string>(n / 8u, "--output"));
+		} });
+		cases.push_back({ "vectorize", "bytes", 25.0, false, [](const size_t n) {
+			auto block{ std::make_shared<opt::CStringArray>(names(n / 8u, "arg")) };
+			return [block]() { bench::do_not_optimize(opt::vectorize(static_cast<int>(block->size()), block->data())); };
+		} });
+		// quotes, escapes & comments on every token
+		cases.push_back({ "tokenize_response", "bytes", 25.0, false, [](const size_t n) {
+			std::string contents;
+			while (contents.size() < n)
+				contents += "\"quoted \\\" arg\" 'single' esc\\ aped # comment\n";
+			return [contents]() { bench::do_not_optimize(opt::tokenize_response(contents)); };
+		} });
+		cases.push_back({ "parseCmdline", "bytes", 50.0, false, [](const size_t n) {
+			std::string buffer{ "program" };
+			while (buffer.size() < n)
+				buffer += " -abc \"quoted file\" --output=\"x y\" -12 --opt";
+			return [buffer]() { bench::do_not_optimize(opt::parseCmdline(buffer, config)); };
+		} });
+		// a query for a name that doesn't exist, which must visit every argument
+		cases.push_back({ "ParamsAPI::find (scan)", "args", 25.0, false, [](const size_t n) {
+			auto api{ std::make_shared<opt::ParamsAPI>(repeated_options(n)) };
+			api->configure_index(opt::AdaptiveIndex::NEVER);
+			return [api]() { bench::do_not_optimize(api->find("not-present")); };
+		} });
+		cases.push_back({ "ParamsAPI::find (index)", "op", 625.0, true, [](const size_t n) {
+			auto api{ std::make_shared<opt::ParamsAPI>(repeated_options(n)) };
+			api->configure_index(0u);
+			return [api]() { bench::do_not_optimize(api->find("not-present")); };
+		} });
+		cases.push_back({ "Params::find", "args", 25.0, false, [](const size_t n) {
+			auto params{ std::make_shared<opt::Params>(repeated_options(n)) };
+			return [params]() { bench::do_not_optimize(params->find("not-present")); };
+		} });
+		cases.push_back({ "Params::getAllWithTypeMatching", "args", 75.0, false, [](const size_t n) {
+			auto params{ std::make_shared<opt::Params>(repeated_options(n)) };
+			return [params]() { bench::do_not_optimize(params->getAllWithTypeMatching<opt::Option>("opt0")); };
+		} });
+		cases.push_back({ "EnvView", "vars", 125.0, false, [](const size_t n) {
+			auto vars{ std::make_shared<std::vector<std::string>>(names(n, "VAR")) };
+			for (auto& it : *vars)
+				it += "=value";
+			auto block{ std::make_shared<opt::CStringArray>(*vars) };
+			return [block]() { bench::do_not_optimize(opt::EnvView{ block->data() }); };
+		} });
+		// distinct names added one at a time, which grows the builder's index incrementally
+		cases.push_back({ "EnvBuilder::set", "vars", 500.0, false, [](const size_t n) {
+			auto vars{ std::make_shared<std::vector<std::string>>(names(n, "VAR")) };
+			return [vars]() {
+				opt::EnvBuilder env;
+				for (const auto& it : *vars)
+					env.set(it, "value");
+				bench::do_not_optimize(env.size());
+			};
+		} });
+		cases.push_back({ "serialize", "args", 125.0, false, [](const size_t n) {
+			auto cont{ std::make_shared<opt::ContainerType>(mixed(n)) };
+			return [cont]() { bench::do_not_optimize(opt::serialize(*cont)); };
+		} });
+		cases.push_back({ "deserialize", "args", 250.0, false, [](const size_t n) {
+			const auto str{ opt::serialize(mixed(n)) };
+			return [str]() {
+				std::string_view in{ str };
+				bench::do_not_optimize(opt::deserialize(in));
+			};
+		} });
+		// every character must be escaped
+		cases.push_back({ "serialize_json (escapes)", "bytes", 50.0, false, [](const size_t n) {
+			std::string value;
+			while (value.size() < n)
+				value += "\"\\\n\t\x01";
+			auto cont{ std::make_shared<opt::ContainerType>(opt::parseArgs(std::vector<std::string>{ "--output", value.substr(0u, n) }, config)) };
+			return [cont]() { bench::do_not_optimize(opt::serialize_json(*cont)); };
+		} });
+		cases.push_back({ "canonicalize", "args", 1000.0, false, [](const size_t n) {
+			auto cont{ std::make_shared<opt::ContainerType>(mixed(n)) };
+			return [cont]() { bench::do_not_optimize(opt::canonicalize(*cont)); };
+		} });
+		cases.push_back({ "diffArgs", "args", 2500.0, false, [](const size_t n) {
+			auto l{ std::make_shared<opt::ContainerType>(mixed(n)) }, r{ std::make_shared<opt::ContainerType>(mixed(n, 1u)) };
+			return [l, r]() { bench::do_not_optimize(opt::diffArgs(*l, *r)); };
+		} });
+		cases.push_back({ "render_argv", "args", 125.0, false, [](const size_t n) {
+			auto cont{ std::make_shared<opt::ContainerType>(mixed(n)) };
+			auto block{ std::make_shared<opt::CStringArray>() };
+			return [cont, block]() { bench::do_not_optimize(opt::render_argv(*block, *cont)); };
+		} });
+		return cases;
+	}
+
+	/**
+	 * @brief Fit a line through (log n, log ns) with least squares.
+	 * @param results	- Measurements of one case, with at least 2 different sizes.
+	 * @returns double	- The slope of the line, which is the exponent of the scaling curve.
+	 */
+	double fit_slope(const std::vector<bench::Result>& results)
+	{
+		double sx{ 0.0 }, sy{ 0.0 }, sxx{ 0.0 }, sxy{ 0.0 };
+		for (const auto& it : results) {
+			const auto x{ std::log(static_cast<double>(it.n)) }, y{ std::log(std::max(it.ns_per_op, 1e-3)) };
+			sx += x;
+			sy += y;
+			sxx += x * x;
+			sxy += x * y;
+		}
+		const auto count{ static_cast<double>(results.size()) };
+		return (count * sxy - sx * sy) / (count * sxx - sx * sx);
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const opt::ParamsAPI args{ argc, argv, "min-size", "max-size", "min-time", "repeat", "max-slope", "filter" };
+	const auto min_size{ std::stoull(args.getv("min-size").value_or("4096")) };
+	const auto max_size{ std::stoull(args.getv("max-size").value_or("262144")) };
+	const std::chrono::milliseconds min_time{ std::stoll(args.getv("min-time").value_or("20")) };
+	const auto repeat{ std::max(std::stoull(args.getv("repeat").value_or("3")), 1ull) };
+	const auto max_slope{ std::stod(args.getv("max-slope").value_or("1.5")) };
+	const auto filter{ args.getv("filter").value_or("") };
+	if (min_size == 0u || max_size < min_size * 2u) {
+		std::fputs("--max-size must be at least twice --min-size, so that the slope can be fitted.\n", stderr);
+		return 1;
+	}
+
+	// measure every size of a case, & keep the fastest batch of each
+	const auto measure{ [&](const Case& c) {
+		std::vector<bench::Result> results;
+		for (size_t n{ min_size }; n <= max_size; n *= 2u) {
+			const auto fn{ c.prepare(n) };
+			auto best{ bench::run(c.name, n, fn, min_time) };
+			for (auto i{ 1ull }; i < repeat; ++i)
+				if (auto result{ bench::run(c.name, n, fn, min_time) }; result.ns_per_op < best.ns_per_op)
+					best = std::move(result);
+			results.emplace_back(std::move(best));
+			bench::print(results.back());
+		}
+		return results;
+	} };
+	// the time per unit of input at the largest size, or the time per operation for constant cases
+	const auto cost_of{ [](const Case& c, const std::vector<bench::Result>& results) {
+		return c.constant ? results.back().ns_per_op : results.back().ns_per_op / static_cast<double>(results.back().n);
+	} };
+
+	bench::print_header();
+	const auto reference{ make_reference() };
+	const auto reference_cost{ std::max(cost_of(reference, measure(reference)), 1e-3) };
+	std::printf("%-40s %.3f ns/%s, which budgets are multiples of\n\n", reference.name.c_str(), reference_cost, reference.unit.c_str());
+
+	std::vector<std::string> failures;
+	for (const auto& c : make_cases()) {
+		if (!filter.empty() && c.name.find(filter) == std::string::npos)
+			continue;
+		const auto results{ measure(c) };
+		const auto slope{ fit_slope(results) };
+		const auto limit{ c.constant ? max_slope - 1.0 : max_slope };
+		const auto cost{ cost_of(c, results) }, relative{ cost / reference_cost };
+		const bool ok{ slope <= limit && relative <= c.budget };
+		std::printf("%-40s slope %.2f (limit %.2f), %.2f ns/%s = %.1fx reference (budget %.1fx) %s\n\n", c.name.c_str(), slope, limit, cost, c.unit.c_str(), relative, c.budget, ok ? "OK" : "FAIL");
+		std::fflush(stdout);
+		if (!ok)
+			failures.emplace_back(c.name);
+	}
+
+	if (failures.empty())
+		return 0;
+	std::fprintf(stderr, "%zu case(s) scaled superlinearly or exceeded their budget:\n", failures.size());
+	for (const auto& it : failures)
+		std::fprintf(stderr, "\t%s\n", it.c_str());
+	return 1;
+}
\ No newline at end of file
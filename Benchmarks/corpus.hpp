@@ -0,0 +1,229 @@
+/**
+ * @file corpus.hpp
+ * @author radj307
+ * @brief Seeded generator of synthetic commandlines for benchmarking, with realistic & adversarial shapes, & a loader for recorded commandlines.
+ *\n	  The same shape, size & seed always produce the same commandline, on every platform.
+ */
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <parseResponseFile.hpp>
+
+namespace corpus {
+	/**
+	 * @enum Shape
+	 * @brief The kinds of commandline that the generator can produce.
+	 */
+	enum class Shape : unsigned char {
+		MIXED,				///< @brief A realistic mix of every other shape.
+		FLAG_CLUSTERS,		///< @brief Dense clusters of flags, such as "-hvac".
+		LONG_OPTIONS,		///< @brief Long options, about half of which capture the following argument.
+		NUMBERS,			///< @brief Negative numbers, decimals & hex-looking values, which must be parsed as parameters.
+		PARAMETERS,			///< @brief A huge list of parameters, such as file paths from a shell glob.
+		DEFINES,			///< @brief Compiler-style floods of "-DKEY=VALUE", "-I<path>" & "-O2", which are parsed as flag clusters.
+	};
+	/// @brief Every shape, in order.
+	inline constexpr Shape ALL_SHAPES[]{ Shape::MIXED, Shape::FLAG_CLUSTERS, Shape::LONG_OPTIONS, Shape::NUMBERS, Shape::PARAMETERS, Shape::DEFINES };
+
+	/**
+	 * @brief Retrieve the name of a shape.
+	 * @param shape	- Input shape.
+	 * @returns std::string_view
+	 */
+	constexpr std::string_view get_shapename(const Shape shape)
+	{
+		switch (shape) {
+		case Shape::MIXED:
+			return "mixed";
+		case Shape::FLAG_CLUSTERS:
+			return "flag-clusters";
+		case Shape::LONG_OPTIONS:
+			return "long-options";
+		case Shape::NUMBERS:
+			return "numbers";
+		case Shape::PARAMETERS:
+			return "parameters";
+		case Shape::DEFINES:
+			return "defines";
+		default:
+			return{};
+		}
+	}
+
+	/**
+	 * @brief Retrieve the capture list that should be used when parsing commandlines generated with any shape.
+	 * @returns std::vector<std::string>
+	 */
+	inline std::vector<std::string> capture_list()
+	{
+		return{ "output", "config", "level", "o" };
+	}
+
+	/**
+	 * @class Generator
+	 * @brief Deterministic commandline generator. Only the raw output of std::mt19937_64 is used, because the standard distributions differ between implementations.
+	 */
+	class Generator {
+		std::mt19937_64 _rng;
+
+		static constexpr std::string_view FLAGS{ "abcdefghijklmnpqrstuvwxyzABCHLMNSVW" };	///< @brief Flag characters. 'o' is excluded, because it captures.
+		static constexpr std::string_view WORDS[]{ "alpha", "beta", "gamma", "delta", "epsilon", "verbose", "quiet", "force", "recursive", "dry-run", "no-color", "jobs", "include", "exclude", "timeout" };
+		static constexpr std::string_view CAPTURING[]{ "output", "config", "level" };
+		static constexpr std::string_view DIRS[]{ "src", "include", "lib", "build", "test", "docs", "/usr/include", "/opt/local/include" };
+		static constexpr std::string_view EXTS[]{ ".cpp", ".hpp", ".h", ".c", ".txt", ".json", "" };
+
+		uint64_t next() { return _rng(); }
+		size_t below(const size_t n) { return static_cast<size_t>(next() % n); }
+		template<class T, size_t N> const T& pick(const T(&arr)[N]) { return arr[below(N)]; }
+
+		std::string flag_cluster()
+		{
+			std::string str{ "-" };
+			for (auto len{ 1u + below(8u) }; len > 0u; --len)
+				str.push_back(FLAGS[below(FLAGS.size())]);
+			return str;
+		}
+		std::string number()
+		{
+			switch (below(4u)) {
+			case 0u:
+				return '-' + std::to_string(below(100000u));
+			case 1u:
+				return '-' + std::to_string(below(1000u)) + '.' + std::to_string(below(1000u));
+			case 2u: {
+				constexpr char hex[]{ "0123456789ABCDEF" };
+				std::string str{ below(2u) == 0u ? "0x" : "-0x" };
+				for (auto len{ 2u + below(6u) }; len > 0u; --len)
+					str.push_back(hex[below(16u)]);
+				return str;
+			}
+			default:
+				return std::to_string(below(1000000u));
+			}
+		}
+		std::string path()
+		{
+			std::string str{ pick(DIRS) };
+			(str += '/') += pick(WORDS);
+			str += std::to_string(below(1000u));
+			str += pick(EXTS);
+			return str;
+		}
+		std::string define()
+		{
+			switch (below(4u)) {
+			case 0u:
+				return "-I" + std::string{ pick(DIRS) };
+			case 1u:
+				return "-O" + std::to_string(below(4u));
+			default: {
+				std::string str{ "-D" };
+				for (char ch : pick(WORDS))
+					str.push_back(ch >= 'a' && ch <= 'z' ? static_cast<char>(ch - 'a' + 'A') : ch == '-' ? '_' : ch);
+				(str += '=') += std::to_string(below(100u));
+				return str;
+			}
+			}
+		}
+
+		/**
+		 * @brief Append the arguments for one element of a shape. Some elements produce more than one argument, but the vector never exceeds n.
+		 * @param vec	- Output vector.
+		 * @param shape	- Shape of the element.
+		 * @param n		- Maximum size of the vector.
+		 */
+		void element(std::vector<std::string>& vec, const Shape shape, const size_t n)
+		{
+			switch (shape) {
+			case Shape::FLAG_CLUSTERS:
+				vec.emplace_back(flag_cluster());
+				break;
+			case Shape::LONG_OPTIONS:
+				if (below(2u) == 0u) {
+					vec.emplace_back("--" + std::string{ pick(CAPTURING) });
+					if (vec.size() < n)
+						vec.emplace_back(below(4u) == 0u ? std::string{} : path()); // captures are occasionally empty
+				}
+				else vec.emplace_back("--" + std::string{ pick(WORDS) });
+				break;
+			case Shape::NUMBERS:
+				vec.emplace_back(number());
+				break;
+			case Shape::PARAMETERS:
+				vec.emplace_back(path());
+				break;
+			case Shape::DEFINES:
+				vec.emplace_back(define());
+				break;
+			case Shape::MIXED: [[fallthrough]];
+			default: {
+				// weighted towards the shapes seen in real commandlines
+				constexpr Shape weights[]{ Shape::FLAG_CLUSTERS, Shape::LONG_OPTIONS, Shape::LONG_OPTIONS, Shape::LONG_OPTIONS, Shape::PARAMETERS, Shape::PARAMETERS, Shape::NUMBERS, Shape::DEFINES };
+				element(vec, pick(weights), n);
+				break;
+			}
+			}
+		}
+
+	public:
+		/**
+		 * @brief Constructor.
+		 * @param seed	- Random seed.
+		 */
+		explicit Generator(const uint64_t seed = 0u) : _rng{ seed } {}
+
+		/**
+		 * @brief Generate a commandline, not including argv[0].
+		 * @param shape	- Shape of the commandline.
+		 * @param n		- Number of arguments.
+		 * @returns std::vector<std::string>
+		 */
+		std::vector<std::string> generate(const Shape shape, const size_t n)
+		{
+			std::vector<std::string> vec;
+			vec.reserve(n);
+			while (vec.size() < n)
+				element(vec, shape, n);
+			return vec;
+		}
+	};
+
+	/**
+	 * @brief Generate a commandline, not including argv[0].
+	 * @param shape	- Shape of the commandline.
+	 * @param n		- Number of arguments.
+	 * @param seed	- Random seed.
+	 * @returns std::vector<std::string>
+	 */
+	inline std::vector<std::string> generate(const Shape shape, const size_t n, const uint64_t seed = 0u)
+	{
+		return Generator{ seed }.generate(shape, n);
+	}
+
+	/**
+	 * @brief Load recorded commandlines from a file, for replaying real-world workloads.
+	 *\n	  Each line contains one commandline, not including argv[0], which is split in the same way as a response file. (see opt::tokenize_response)
+	 *\n	  Blank lines & lines beginning with '#' are ignored.
+	 * @param path	- Path to the file.
+	 * @returns std::vector<std::vector<std::string>>
+	 * @throws std::runtime_error	- If the file could not be opened.
+	 */
+	inline std::vector<std::vector<std::string>> load(const std::filesystem::path& path)
+	{
+		std::ifstream ifs{ path };
+		if (!ifs.is_open())
+			throw std::runtime_error("Failed to open corpus file!");
+		std::vector<std::vector<std::string>> vec;
+		for (std::string line; std::getline(ifs, line);) {
+			if (const auto pos{ line.find_first_not_of(" \t\r") }; pos == std::string::npos || line[pos] == '#')
+				continue;
+			vec.emplace_back(opt::tokenize_response(line));
+		}
+		return vec;
+	}
+}
\ No newline at end of file
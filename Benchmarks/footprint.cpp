@@ -0,0 +1,176 @@
+/**
+ * @file footprint.cpp
+ * @author radj307
+ * @brief Measures the memory retained by Params & ParamsAPI for each generated commandline shape, & fails when it grows past a stored baseline.
+ *\n	  The retained bytes of each instance are the growth of the live heap while constructing it from argc & argv, plus its own size.
+ *\n	  They are broken down into the container's used slots (size * sizeof(VariantArgument)), its slack capacity,
+ *\n	  the heap used by names & captures that don't fit in the small string buffer, & anything else, such as argv[0].
+ *\n	  The vector of strings returned by vectorize() is reported as a reference, since it is the smallest owning copy of the commandline.
+ *\n	  Baselines are specific to the standard library, because it determines sizeof(VariantArgument) & the small string buffer.
+ *\n	  Both are stored in the baseline file, & the program refuses to compare against a baseline that was written with different values.
+ *\n	  Every measured key must be present in the baseline, so a new shape or container fails until the baseline is written again.
+ *\n_USAGE:_
+ *\n	footprint [--n <N>] [--seed <N>] [--baseline <file>] [--tolerance <percent>] [--write-baseline]
+ *\n	--n					Number of arguments in each generated commandline. (Default: 10000)
+ *\n	--seed				Random seed used to generate commandlines. (Default: 0)
+ *\n	--baseline			Baseline file. (Default: footprint-baseline.txt, next to this source file)
+ *\n	--tolerance			Percentage that the bytes per argument may exceed the baseline by. (Default: 2)
+ *\n	--write-baseline	Replace the baseline file with the measured values instead of comparing against it.
+ */
+#define BENCH_DEFINE_ALLOCATION_HOOKS
+#include "bench.hpp"
+#include "corpus.hpp"
+#include <Params.hpp>
+#include <ParamsAPI.hpp>
+#include <CStringArray.hpp>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+	const opt::ParserConfig config{ corpus::capture_list() };
+
+	/**
+	 * @struct Footprint
+	 * @brief The memory retained by one instance, & where it is used.
+	 */
+	struct Footprint {
+		std::string container;	///< @brief Name of the measured type.
+		size_t retained;		///< @brief Total retained bytes, including sizeof the instance.
+		size_t self;			///< @brief sizeof the instance.
+		size_t slots;			///< @brief Bytes used by the container's elements.
+		size_t slack;			///< @brief Bytes reserved by the container's unused capacity.
+		size_t strings;			///< @brief Bytes allocated by strings that are too long for the small string buffer.
+
+		/// @brief Retrieve the retained bytes that aren't accounted for by the other fields.	@returns int64_t
+		[[nodiscard]] int64_t other() const { return static_cast<int64_t>(retained) - static_cast<int64_t>(self + slots + slack + strings); }
+	};
+
+	/**
+	 * @brief Construct an object & measure the heap that it retains.
+	 * @param make	- Function that returns the object.
+	 * @returns size_t	- Bytes retained by the object, including its own size.
+	 */
+	template<class Fn>
+	size_t retained_by(Fn&& make)
+	{
+		const auto before{ bench::live_bytes.load(std::memory_order_relaxed) };
+		const auto obj{ make() };
+		bench::do_not_optimize(obj);
+		return static_cast<size_t>(bench::live_bytes.load(std::memory_order_relaxed) - before) + sizeof(obj);
+	}
+
+	/// @brief Key of the baseline line that records sizeof(VariantArgument).
+	const std::string VARIANT_SIZE_KEY{ "layout sizeof(VariantArgument)" };
+	/// @brief Key of the baseline line that records the capacity of the small string buffer.
+	const std::string SSO_CAPACITY_KEY{ "layout small-string-capacity" };
+
+	/// @brief Reads a baseline file, which has one "<shape> <container> <bytes per argument>" line per measurement, & the "layout" lines. Lines beginning with '#' are ignored.
+	std::map<std::string, double> read_baseline(const std::filesystem::path& path)
+	{
+		std::map<std::string, double> baseline;
+		std::ifstream file{ path };
+		for (std::string line; std::getline(file, line);) {
+			if (line.empty() || line.front() == '#')
+				continue;
+			std::istringstream ss{ line };
+			std::string shape, container;
+			double per_arg;
+			if (ss >> shape >> container >> per_arg)
+				baseline[shape + ' ' + container] = per_arg;
+		}
+		return baseline;
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const opt::ParamsAPI args{ argc, argv, "n", "seed", "baseline", "tolerance" };
+	const auto n{ std::stoull(args.getv("n").value_or("10000")) };
+	const auto seed{ std::stoull(args.getv("seed").value_or("0")) };
+	const std::filesystem::path baseline_path{ args.getv("baseline").value_or((std::filesystem::path{ __FILE__ }.parent_path() / "footprint-baseline.txt").string()) };
+	const auto tolerance{ std::stod(args.getv("tolerance").value_or("2")) / 100.0 };
+	const auto write_baseline{ args.check_opt("write-baseline") };
+	const auto baseline{ write_baseline ? std::map<std::string, double>{} : read_baseline(baseline_path) };
+	const auto variant_size{ sizeof(opt::VariantArgument) }, sso_capacity{ std::string{}.capacity() };
+	if (!write_baseline) {
+		if (baseline.empty()) {
+			std::fprintf(stderr, "No baseline was found at \"%s\". Use --write-baseline to create one.\n", baseline_path.string().c_str());
+			return 1;
+		}
+		// footprints measured with a different layout can't be compared, so refuse instead of reporting meaningless differences
+		const auto variant_it{ baseline.find(VARIANT_SIZE_KEY) }, sso_it{ baseline.find(SSO_CAPACITY_KEY) };
+		if (variant_it == baseline.end() || sso_it == baseline.end() || variant_it->second != static_cast<double>(variant_size) || sso_it->second != static_cast<double>(sso_capacity)) {
+			std::fprintf(stderr, "The baseline at \"%s\" was written with a different sizeof(VariantArgument) or small string buffer than this build (%zu, %zu), so it can't be compared. Use --write-baseline to replace it.\n",
+				baseline_path.string().c_str(), variant_size, sso_capacity);
+			return 1;
+		}
+	}
+
+	std::printf("sizeof(VariantArgument) = %zu, sizeof(std::string) = %zu, small string buffer = %zu\n\n", variant_size, sizeof(std::string), sso_capacity);
+	std::printf("%-14s %-20s %8s %12s %8s %12s %12s %12s %10s %12s %10s %10s\n", "shape", "container", "args", "retained", "self", "slots", "slack", "strings", "other", "bytes/arg", "baseline", "status");
+
+	std::ostringstream out;
+	out << "# Retained bytes per argument, measured by footprint.cpp with --n " << n << " --seed " << seed << ".\n";
+	out << "# sizeof(std::string) = " << sizeof(std::string) << '\n';
+	out << VARIANT_SIZE_KEY << ' ' << variant_size << '\n';
+	out << SSO_CAPACITY_KEY << ' ' << sso_capacity << '\n';
+	size_t failures{ 0u };
+	for (const auto shape : corpus::ALL_SHAPES) {
+		auto commandline{ corpus::generate(shape, n, seed) };
+		commandline.insert(commandline.begin(), "program");
+		opt::CStringArray block{ commandline };
+		const auto count{ static_cast<int>(block.size()) };
+
+		// Params & ParamsAPI parse with the same parseArgs overload, so this container has the same size, capacity & strings as theirs
+		opt::ParseStats stats;
+		bench::do_not_optimize(opt::parseArgs(opt::vectorize(count, block.data()), config, &stats));
+		const auto slots{ stats.size * sizeof(opt::VariantArgument) }, slack{ (stats.capacity - stats.size) * sizeof(opt::VariantArgument) };
+
+		// vectorize() skips argv[0]
+		size_t vector_strings{ 0u };
+		for (auto it{ commandline.begin() + 1 }; it != commandline.end(); ++it)
+			if (it->size() > sso_capacity)
+				vector_strings += it->size() + 1u;
+
+		const Footprint footprints[]{
+			{ "vector<string>", retained_by([&]() { return opt::vectorize(count, block.data()); }), sizeof(std::vector<std::string>), n * sizeof(std::string), 0u, vector_strings },
+			{ "Params", retained_by([&]() { return opt::Params{ count, block.data(), config }; }), sizeof(opt::Params), slots, slack, stats.heap_bytes },
+			{ "ParamsAPI", retained_by([&]() { return opt::ParamsAPI{ count, block.data(), std::optional<opt::ParserConfig>{ config } }; }), sizeof(opt::ParamsAPI), slots, slack, stats.heap_bytes },
+		};
+		const std::string shape_name{ corpus::get_shapename(shape) };
+		for (const auto& it : footprints) {
+			const auto per_arg{ static_cast<double>(it.retained) / static_cast<double>(n) };
+			const auto key{ shape_name + ' ' + it.container };
+			const auto expected{ baseline.find(key) };
+			// the reference is only reported, since it doesn't depend on this library
+			const bool checked{ !write_baseline && it.container != "vector<string>" };
+			const bool missing{ checked && expected == baseline.end() };
+			const bool ok{ !checked || (!missing && per_arg <= expected->second * (1.0 + tolerance)) };
+			if (!ok)
+				++failures;
+			std::printf("%-14s %-20s %8zu %12zu %8zu %12zu %12zu %12zu %10lld %12.1f", shape_name.c_str(), it.container.c_str(), static_cast<size_t>(n), it.retained, it.self, it.slots, it.slack, it.strings, static_cast<long long>(it.other()), per_arg);
+			if (missing)
+				std::printf(" %10s %10s\n", "-", "MISSING");
+			else if (checked)
+				std::printf(" %10.1f %10s\n", expected->second, ok ? "OK" : "FAIL");
+			else std::printf(" %10s %10s\n", "-", "-");
+			if (it.container != "vector<string>") {
+				char line[64];
+				std::snprintf(line, sizeof(line), "%.1f", per_arg);
+				out << key << ' ' << line << '\n';
+			}
+		}
+	}
+
+	if (write_baseline) {
+		std::ofstream{ baseline_path } << out.str();
+		std::printf("\nWrote the baseline to \"%s\".\n", baseline_path.string().c_str());
+		return 0;
+	}
+	if (failures == 0u)
+		return 0;
+	std::fprintf(stderr, "%zu footprint(s) grew by more than %.1f%% past the baseline, or are missing from it.\n", failures, tolerance * 100.0);
+	return 1;
+}
\ No newline at end of file
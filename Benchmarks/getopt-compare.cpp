@@ -0,0 +1,153 @@
+/**
+ * @file getopt-compare.cpp
+ * @author radj307
+ * @brief Compares the cost of parsing identical commandlines with getopt_long & with ParamsAPI, followed by the queries a typical program makes.
+ *\n	  Both parsers are given the same option spec: every flag character from the corpus, the long options in LONG_OPTIONS,
+ *\n	  & the capturing long options from corpus::capture_list(), which take a required argument.
+ *\n	  Requires a platform that provides getopt_long. (glibc, musl, BSD libc)
+ *\n_USAGE:_
+ *\n	getopt-compare [--max <N>] [--min-time <ms>] [--seed <N>]
+ */
+#define BENCH_DEFINE_ALLOCATION_HOOKS
+#include "bench.hpp"
+#include "corpus.hpp"
+#include <ParamsAPI.hpp>
+#include <CStringArray.hpp>
+#if __has_include(<getopt.h>)
+#include <getopt.h>
+
+namespace {
+	/// @brief Long options without arguments, which matches the words used by corpus::Generator.
+	constexpr const char* LONG_OPTIONS[]{ "alpha", "beta", "gamma", "delta", "epsilon", "verbose", "quiet", "force", "recursive", "dry-run", "no-color", "jobs", "include", "exclude", "timeout" };
+	/// @brief Long options with a required argument, which matches corpus::capture_list().
+	constexpr const char* CAPTURING[]{ "output", "config", "level" };
+	/// @brief Short options for getopt_long. The leading '-' returns parameters in order instead of permuting argv, & ':' reports missing arguments separately.
+	constexpr const char* SHORT_OPTIONS{ "-:abcdefghijklmnpqrstuvwxyzABCHLMNSVWo:" };
+
+	/**
+	 * @brief The results that a typical program stores while parsing its commandline with getopt_long.
+	 */
+	struct GetoptResult {
+		bool flags[256]{};
+		bool long_flags[std::size(LONG_OPTIONS)]{};
+		const char* captures[std::size(CAPTURING)]{};
+		std::vector<const char*> parameters;
+		size_t unknown{ 0u };
+	};
+
+	std::vector<option> make_longopts()
+	{
+		std::vector<option> vec;
+		for (int i{ 0 }; i < static_cast<int>(std::size(LONG_OPTIONS)); ++i)
+			vec.push_back(option{ LONG_OPTIONS[i], no_argument, nullptr, 0x100 + i });
+		for (int i{ 0 }; i < static_cast<int>(std::size(CAPTURING)); ++i)
+			vec.push_back(option{ CAPTURING[i], required_argument, nullptr, 0x200 + i });
+		vec.push_back(option{ nullptr, 0, nullptr, 0 });
+		return vec;
+	}
+	const auto longopts{ make_longopts() };
+
+	/**
+	 * @brief Parse a commandline with getopt_long.
+	 * @param argc	- Argument count, including argv[0].
+	 * @param argv	- Argument array. getopt_long requires it to be mutable.
+	 * @param out	- Results. This is reset before parsing, but keeps its capacity.
+	 */
+	void parse_getopt(const int argc, char** argv, GetoptResult& out)
+	{
+		out = GetoptResult{ .parameters = std::move(out.parameters) };
+		out.parameters.clear();
+		optind = 0; // reinitialize getopt's internal state
+		opterr = 0;
+		for (int ch; (ch = getopt_long(argc, argv, SHORT_OPTIONS, longopts.data(), nullptr)) != -1;) {
+			if (ch == 1)
+				out.parameters.emplace_back(optarg);
+			else if (ch >= 0x200)
+				out.captures[ch - 0x200] = optarg;
+			else if (ch >= 0x100)
+				out.long_flags[ch - 0x100] = true;
+			else if (ch == '?' || ch == ':')
+				++out.unknown;
+			else
+				out.flags[static_cast<unsigned char>(ch)] = true;
+		}
+	}
+
+	/**
+	 * @brief Parse a commandline with ParamsAPI, in the same way as its (argc, argv) constructor, but without copying the parser config.
+	 * @param argc		- Argument count, including argv[0].
+	 * @param argv		- Argument array.
+	 * @param config	- Parser configuration.
+	 * @returns opt::ParamsAPI
+	 */
+	opt::ParamsAPI parse_api(const int argc, char** argv, const opt::ParserConfig& config)
+	{
+		return opt::ParamsAPI{ opt::parseArgs(opt::vectorize(argc, argv), config), argv[0] };
+	}
+}
+
+int main(const int argc, char** argv)
+{
+	const opt::ParamsAPI args{ argc, argv, "max", "min-time", "seed" };
+	const auto max{ std::stoull(args.getv("max").value_or("100000")) };
+	const std::chrono::milliseconds min_time{ std::stoll(args.getv("min-time").value_or("100")) };
+	const auto seed{ std::stoull(args.getv("seed").value_or("0")) };
+	const opt::ParserConfig config{ corpus::capture_list() };
+
+	bench::print_header();
+	// NUMBERS & DEFINES are excluded, because getopt_long treats negative numbers as unknown flags rather than parameters
+	for (const auto shape : { corpus::Shape::FLAG_CLUSTERS, corpus::Shape::LONG_OPTIONS, corpus::Shape::PARAMETERS }) {
+		for (size_t n{ 10u }; n <= max; n *= 10u) {
+			auto commandline{ corpus::generate(shape, n, seed) };
+			commandline.insert(commandline.begin(), "program");
+			opt::CStringArray block{ commandline };
+			std::vector<char*> scratch(block.begin(), block.end() + 1); // getopt_long may modify argv, so each run parses a fresh copy of the pointers, including the terminating NULL
+			const auto count{ static_cast<int>(block.size()) };
+			const std::string label{ '[' + std::string{ corpus::get_shapename(shape) } + "] " };
+
+			// end-to-end cost of one invocation: parsing followed by the queries a typical program makes
+			GetoptResult result;
+			bench::print(bench::run(label + "getopt_long + queries", n, [&]() {
+				std::copy(block.begin(), block.end(), scratch.begin());
+				parse_getopt(count, scratch.data(), result);
+				bench::do_not_optimize(result.flags['v']);
+				bench::do_not_optimize(result.long_flags[5]);
+				bench::do_not_optimize(result.captures[0]);
+				bench::do_not_optimize(result.parameters.size());
+			}, min_time));
+			bench::print(bench::run(label + "ParamsAPI + queries", n, [&]() {
+				const auto api{ parse_api(count, block.data(), config) };
+				bench::do_not_optimize(api.check_flag('v'));
+				bench::do_not_optimize(api.check_opt("verbose"));
+				bench::do_not_optimize(api.getv("output"));
+				bench::do_not_optimize(api.getAllParameters().size());
+			}, min_time));
+
+			// parsing alone
+			bench::print(bench::run(label + "getopt_long (parse)", n, [&]() {
+				std::copy(block.begin(), block.end(), scratch.begin());
+				parse_getopt(count, scratch.data(), result);
+				bench::do_not_optimize(result.unknown);
+			}, min_time));
+			bench::print(bench::run(label + "ParamsAPI (parse)", n, [&]() {
+				bench::do_not_optimize(parse_api(count, block.data(), config));
+			}, min_time));
+
+			// individual queries, after parsing. getopt_long's results are plain struct members, so ParamsAPI's cost is compared against a member read.
+			const auto api{ parse_api(count, block.data(), config) };
+			bench::print(bench::run(label + "getopt_long query", n, [&]() { bench::do_not_optimize(result.captures[0]); }, min_time));
+			bench::print(bench::run(label + "ParamsAPI::check_flag", n, [&]() { bench::do_not_optimize(api.check_flag('v')); }, min_time));
+			bench::print(bench::run(label + "ParamsAPI::check_opt", n, [&]() { bench::do_not_optimize(api.check_opt("verbose")); }, min_time));
+			bench::print(bench::run(label + "ParamsAPI::getv", n, [&]() { bench::do_not_optimize(api.getv("output")); }, min_time));
+		}
+	}
+	return 0;
+}
+#else
+#include <cstdio>
+int main()
+{
+	std::fputs("getopt-compare requires getopt_long, which is not available on this platform.\n", stderr);
+	return 1;
+}
+#endif
\ No newline at end of file
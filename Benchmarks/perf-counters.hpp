@@ -0,0 +1,257 @@
+/**
+ * @file perf-counters.hpp
+ * @author radj307
+ * @brief Reads hardware performance counters (cycles, instructions, cache misses & branch mispredictions) with Linux's perf_event_open.
+ *\n	  The counters are opened as one group, so that the kernel schedules them together & ratios such as instructions per cycle come from the same interval.
+ *\n	  Counters that can't join the group are opened separately, & counters that the CPU doesn't support are skipped without losing the others.
+ *\n	  When the kernel disallows access, such as when /proc/sys/kernel/perf_event_paranoid is too high or inside of a container,
+ *\n	  or on platforms other than Linux, no counters are available & error() describes why.
+ */
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BENCH_HAS_PERF_EVENTS
+#endif
+
+namespace bench {
+	/**
+	 * @enum Counter
+	 * @brief The hardware events that can be counted.
+	 */
+	enum class Counter : unsigned char {
+		CYCLES,			///< @brief CPU cycles.
+		INSTRUCTIONS,	///< @brief Retired instructions.
+		L1D_MISSES,		///< @brief Level 1 data cache read misses.
+		LLC_MISSES,		///< @brief Last level cache read misses.
+		BRANCH_MISSES,	///< @brief Mispredicted branches.
+	};
+	/// @brief Number of values in Counter.
+	inline constexpr size_t COUNTER_COUNT{ 5u };
+
+	/**
+	 * @brief Returns the name of a counter, as used in column headers.
+	 * @param counter	- Counter.
+	 * @returns std::string_view
+	 */
+	constexpr std::string_view get_countername(const Counter counter)
+	{
+		switch (counter) {
+		case Counter::CYCLES:
+			return "cycles";
+		case Counter::INSTRUCTIONS:
+			return "instructions";
+		case Counter::L1D_MISSES:
+			return "L1d-misses";
+		case Counter::LLC_MISSES:
+			return "LLC-misses";
+		case Counter::BRANCH_MISSES:
+			return "branch-misses";
+		default:
+			return{};
+		}
+	}
+
+	/// @brief The value of each counter, or std::nullopt for counters that are unavailable.
+	using CounterValues = std::array<std::optional<uint64_t>, COUNTER_COUNT>;
+
+	/**
+	 * @class PerfCounters
+	 * @brief Counts hardware events in user space for the calling thread, between calls to start() & stop().
+	 */
+	class PerfCounters {
+		/// @brief A counter's value & how long it was enabled & running, which only increase until it is reset.
+		struct Sample {
+			uint64_t value, time_enabled, time_running;
+		};
+		using Samples = std::array<std::optional<Sample>, COUNTER_COUNT>;
+
+		std::array<int, COUNTER_COUNT> _fds;	///< @brief File descriptor of each counter, or -1 if it couldn't be opened.
+		std::array<bool, COUNTER_COUNT> _grouped{};	///< @brief True for counters that are members of the group, which are read through the leader.
+		int _leader{ -1 };						///< @brief File descriptor of the group leader, or -1 if no counter could be opened as one.
+		std::array<std::string, COUNTER_COUNT> _errors;	///< @brief Why each unavailable counter couldn't be opened.
+		Samples _start;							///< @brief Samples taken by start().
+
+	#ifdef BENCH_HAS_PERF_EVENTS
+		/**
+		 * @brief Open a counter.
+		 * @param counter	- Counter to open.
+		 * @param group_fd	- File descriptor of the group leader, or -1 to open the counter as a new group leader or on its own.
+		 * @param group		- When true, the counter is read as a group with PERF_FORMAT_GROUP.
+		 * @returns int		- The file descriptor, or -1 with errno set.
+		 */
+		static int open_counter(const Counter counter, const int group_fd, const bool group)
+		{
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			switch (counter) {
+			case Counter::CYCLES:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CPU_CYCLES;
+				break;
+			case Counter::INSTRUCTIONS:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+				break;
+			case Counter::L1D_MISSES:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8u) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16u);
+				break;
+			case Counter::LLC_MISSES:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8u) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16u);
+				break;
+			case Counter::BRANCH_MISSES:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+				break;
+			}
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;	// counting user space only is allowed at the default perf_event_paranoid level
+			attr.exclude_hv = 1;
+			// the kernel multiplexes counters when there are more than the CPU can count at once, so record how long each one actually ran
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING | (group ? static_cast<uint64_t>(PERF_FORMAT_GROUP) : uint64_t{ 0u });
+			return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+		}
+		/// @brief Read every counter that is available.
+		Samples sample() const noexcept
+		{
+			Samples samples{};
+			if (_leader != -1) {
+				// { nr, time_enabled, time_running, value[nr] }, with the values in the order that the members were added
+				std::array<uint64_t, 3u + COUNTER_COUNT> data{};
+				if (const auto bytes{ read(_leader, data.data(), sizeof(data)) }; bytes >= static_cast<ssize_t>(3u * sizeof(uint64_t))) {
+					for (size_t i{ 0u }, member{ 0u }; i < COUNTER_COUNT && member < data[0]; ++i)
+						if (_grouped[i])
+							samples[i] = Sample{ data[3u + member++], data[1], data[2] };
+				}
+			}
+			for (size_t i{ 0u }; i < COUNTER_COUNT; ++i)
+				if (Sample data{}; _fds[i] != -1 && !_grouped[i] && read(_fds[i], &data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)))
+					samples[i] = data;
+			return samples;
+		}
+		/// @brief Apply an ioctl request to the group & to every counter that isn't in it.
+		void control(const unsigned long request) const noexcept
+		{
+			if (_leader != -1)
+				ioctl(_leader, request, PERF_IOC_FLAG_GROUP);
+			for (size_t i{ 0u }; i < COUNTER_COUNT; ++i)
+				if (_fds[i] != -1 && !_grouped[i])
+					ioctl(_fds[i], request, 0);
+		}
+		static std::string describe(const int error)
+		{
+			switch (error) {
+			case EACCES:
+			case EPERM:
+				return "access to performance counters is not permitted (see /proc/sys/kernel/perf_event_paranoid)";
+			case ENOSYS:
+				return "perf_event_open is not available";
+			case ENOENT:
+			case EOPNOTSUPP:
+				return "the event is not supported by this CPU";
+			default:
+				return std::strerror(error);
+			}
+		}
+	#endif
+
+	public:
+		/// @brief Constructor. Opens every counter that is available.
+		PerfCounters()
+		{
+			_fds.fill(-1);
+		#ifdef BENCH_HAS_PERF_EVENTS
+			for (size_t i{ 0u }; i < COUNTER_COUNT; ++i) {
+				const auto counter{ static_cast<Counter>(i) };
+				_fds[i] = open_counter(counter, _leader, true);
+				if (_fds[i] != -1) {
+					_grouped[i] = true;
+					if (_leader == -1)
+						_leader = _fds[i];
+				}
+				else if (_fds[i] = open_counter(counter, -1, false); _fds[i] == -1) // counters that can't join the group may still be counted on their own
+					_errors[i] = describe(errno);
+			}
+		#else
+			_errors.fill("hardware counters require Linux's perf_event_open");
+		#endif
+		}
+		PerfCounters(const PerfCounters&) = delete;
+		PerfCounters& operator=(const PerfCounters&) = delete;
+		~PerfCounters()
+		{
+		#ifdef BENCH_HAS_PERF_EVENTS
+			for (const auto fd : _fds)
+				if (fd != -1)
+					close(fd);
+		#endif
+		}
+
+		/// @brief Check if a counter was opened.	@returns bool
+		[[nodiscard]] bool available(const Counter counter) const noexcept { return _fds[static_cast<size_t>(counter)] != -1; }
+		/// @brief Check if any counter was opened.	@returns bool
+		[[nodiscard]] bool available() const noexcept
+		{
+			for (const auto fd : _fds)
+				if (fd != -1)
+					return true;
+			return false;
+		}
+		/// @brief Retrieve the reason that a counter couldn't be opened.	@returns const std::string&	- Empty when the counter is available.
+		[[nodiscard]] const std::string& error(const Counter counter) const noexcept { return _errors[static_cast<size_t>(counter)]; }
+		/// @brief Retrieve the reason that the first unavailable counter couldn't be opened.	@returns const std::string&	- Empty when every counter is available.
+		[[nodiscard]] const std::string& error() const noexcept
+		{
+			for (const auto& it : _errors)
+				if (!it.empty())
+					return it;
+			return _errors.front();
+		}
+
+		/// @brief Reset every counter to 0 & begin counting.
+		void start() noexcept
+		{
+		#ifdef BENCH_HAS_PERF_EVENTS
+			control(PERF_EVENT_IOC_RESET);
+			// resetting doesn't clear the enabled & running times, so they are recorded & subtracted by stop()
+			_start = sample();
+			control(PERF_EVENT_IOC_ENABLE);
+		#endif
+		}
+
+		/**
+		 * @brief Stop counting, & retrieve the number of events counted since start().
+		 *\n	  Values of multiplexed counters are scaled up to the whole interval.
+		 * @returns CounterValues
+		 */
+		CounterValues stop() noexcept
+		{
+			CounterValues values{};
+		#ifdef BENCH_HAS_PERF_EVENTS
+			control(PERF_EVENT_IOC_DISABLE);
+			const auto end{ sample() };
+			for (size_t i{ 0u }; i < COUNTER_COUNT; ++i) {
+				if (!_start[i].has_value() || !end[i].has_value())
+					continue;
+				const auto value{ end[i]->value - _start[i]->value };
+				const auto enabled{ end[i]->time_enabled - _start[i]->time_enabled }, running{ end[i]->time_running - _start[i]->time_running };
+				if (running == 0u)
+					continue;
+				values[i] = running == enabled ? value : static_cast<uint64_t>(static_cast<long double>(value) * enabled / running);
+			}
+		#endif
+			return values;
+		}
+	};
+}
\ No newline at end of file
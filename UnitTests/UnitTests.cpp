@@ -28,5 +28,96 @@ namespace UnitTests
 		{
 			Assert::AreEqual(0, tests::test_compare_output(utils::params::_args, utils::paramsapi::_args));
 		}
+		TEST_METHOD(Test_Serialize_Roundtrip)
+		{
+			Assert::AreEqual(0, tests::test_serialize_roundtrip(utils::params::_args));
+			Assert::AreEqual(0, tests::test_serialize_roundtrip(utils::paramsapi::_args));
+		}
+		TEST_METHOD(Test_Frozen_Snapshot)
+		{
+			Assert::AreEqual(0, tests::test_frozen(utils::params::_args));
+			Assert::AreEqual(0, tests::test_frozen(utils::paramsapi::_args));
+		}
+		TEST_METHOD(Test_Parse_Cmdline)
+		{
+			Assert::AreEqual(0, tests::test_cmdline(utils::params::_args));
+			Assert::AreEqual(0, tests::test_cmdline(utils::paramsapi::_args));
+		}
+		TEST_METHOD(Test_Env_View)
+		{
+			Assert::AreEqual(0, tests::test_env_view());
+		}
+		TEST_METHOD(Test_Env_Builder)
+		{
+			Assert::AreEqual(0, tests::test_env_builder());
+		}
+		TEST_METHOD(Test_Render_Argv)
+		{
+			Assert::AreEqual(0, tests::test_render_argv());
+		}
+		TEST_METHOD(Test_Fingerprint)
+		{
+			Assert::AreEqual(0, tests::test_fingerprint());
+		}
+		TEST_METHOD(Test_Canonicalize)
+		{
+			Assert::AreEqual(0, tests::test_canonicalize());
+		}
+		TEST_METHOD(Test_Diff)
+		{
+			Assert::AreEqual(0, tests::test_diff());
+		}
+		TEST_METHOD(Test_Instrument_Allocations)
+		{
+			Assert::AreEqual(0, tests::test_instrument_allocations());
+		}
+		TEST_METHOD(Test_Trace)
+		{
+			Assert::AreEqual(0, tests::test_trace());
+		}
+		TEST_METHOD(Test_Parse_Stats)
+		{
+			Assert::AreEqual(0, tests::test_parse_stats());
+		}
+		TEST_METHOD(Test_Query_Index)
+		{
+			Assert::AreEqual(0, tests::test_query_index());
+		}
+		TEST_METHOD(Test_Env_Builder_Growth)
+		{
+			Assert::AreEqual(0, tests::test_env_builder_growth());
+		}
+		TEST_METHOD(Test_Serialize_Json)
+		{
+			Assert::AreEqual(0, tests::test_serialize_json());
+		}
+		TEST_METHOD(Test_Parse_Flag_Cluster)
+		{
+			Assert::AreEqual(0, tests::test_parse_flag_cluster());
+		}
+		TEST_METHOD(Test_Allow_Capture_Char)
+		{
+			Assert::AreEqual(0, tests::test_allow_capture_char());
+		}
+		TEST_METHOD(Test_Resolve_Path_Scan)
+		{
+			Assert::AreEqual(0, tests::test_resolve_path_scan());
+		}
+		TEST_METHOD(Test_Startup_Context)
+		{
+			Assert::AreEqual(0, tests::test_startup_context());
+		}
+		TEST_METHOD(Test_Resolve_Path_Cache)
+		{
+			Assert::AreEqual(0, tests::test_resolve_path_cache());
+		}
+		TEST_METHOD(Test_Resolve_Paths)
+		{
+			Assert::AreEqual(0, tests::test_resolve_paths());
+		}
+		TEST_METHOD(Test_Frozen_Memfd)
+		{
+			Assert::AreEqual(0, tests::test_frozen_memfd());
+		}
 	};
 }
@@ -12,6 +12,7 @@
 #include <ostream>
 #include <vector>
 #include <string>
+#include <thread>
 #include <CppUnitTestAssert.h>
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
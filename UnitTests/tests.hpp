@@ -83,4 +83,610 @@ namespace tests {
 			return 0;
 		} catch ( ... ) { return -1; }
 	}
+
+	template<class ParamType>
+	int test_serialize_roundtrip(const ParamType& args)
+	{
+		static_assert( std::is_same_v<ParamType, opt::Params> || std::is_same_v<ParamType, opt::ParamsAPI> );
+		try {
+			const opt::ContainerType original{ args.begin(), args.end() };
+			const auto buffer{ opt::serialize(original) };
+			std::string_view in{ buffer };
+			const auto copy{ opt::deserialize(in) };
+			Assert::IsTrue(copy.has_value());
+			Assert::IsTrue(in.empty());
+			Assert::IsTrue(copy.value() == original);
+			// truncated input must be rejected rather than partially parsed
+			std::string_view truncated{ buffer.data(), buffer.size() - 1u };
+			Assert::IsFalse(opt::deserialize(truncated).has_value());
+			// response file tokenization
+			Assert::IsTrue(opt::tokenize_response("-hvac --help \"Hello World!\"\n'6000'") == std::vector<std::string>{ "-hvac", "--help", "Hello World!", "6000" });
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	template<class ParamType>
+	int test_frozen(const ParamType& args)
+	{
+		static_assert( std::is_same_v<ParamType, opt::Params> || std::is_same_v<ParamType, opt::ParamsAPI> );
+		try {
+			const opt::ContainerType original{ args.begin(), args.end() };
+			const auto snapshot{ opt::freeze(original.begin(), original.end()) };
+			const opt::FrozenParams frozen{ snapshot };
+			Assert::AreEqual(original.size(), frozen.size());
+			Assert::IsTrue(frozen.check_flag('h'));
+			Assert::IsTrue(frozen.check_opt("test-inner-dash"));
+			Assert::IsTrue(frozen.check_param("-1024"));
+			Assert::IsTrue(frozen.check("World!"));
+			Assert::IsFalse(frozen.check_opt("Hello"));
+			Assert::IsFalse(frozen.arg0().has_value());
+			const auto thawed{ frozen.thaw() };
+			Assert::IsTrue(opt::ContainerType{ thawed.begin(), thawed.end() } == original);
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	template<class ParamType>
+	int test_cmdline(const ParamType& args)
+	{
+		static_assert( std::is_same_v<ParamType, opt::Params> || std::is_same_v<ParamType, opt::ParamsAPI> );
+		try {
+			const opt::ContainerType original{ args.begin(), args.end() };
+			std::string buffer{ "program" };
+			for (const auto& it : default_commandline)
+				(buffer += '\0') += it;
+			Assert::IsTrue(opt::parseCmdline(buffer) == original);
+			Assert::IsTrue(opt::parseCmdline(buffer + '\0') == original); // trailing NUL
+			opt::CmdlineBatch batch;
+			batch.add(buffer);
+			batch.add({}); // kernel threads have an empty cmdline
+			batch.add(buffer);
+			Assert::AreEqual(size_t{ 3u }, batch.size());
+			Assert::IsTrue(batch[1].empty());
+			Assert::IsFalse(batch[1].arg0().has_value());
+			Assert::IsTrue(std::equal(batch[2].begin(), batch[2].end(), original.begin(), original.end()));
+			Assert::IsTrue(batch[2].arg0() == "program");
+			Assert::IsTrue(batch[0].check_flag('h') && batch[0].check_opt("help") && batch[0].check_param("0x00FE"));
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_env_view()
+	{
+		try {
+			char path[]{ "PATH=/usr/bin::/bin" }, home[]{ "home=/root" }, empty[]{ "EMPTY=" }, home2[]{ "HOME=/home" };
+			char* envp[]{ path, home, empty, home2, nullptr };
+			const opt::EnvView env{ envp };
+			Assert::AreEqual(size_t{ 4u }, env.size());
+			Assert::IsTrue(env.get("HOME") == "/root"); // the first case-insensitive match wins
+			Assert::IsTrue(env.get("HOME", true) == "/home");
+			Assert::IsFalse(env.get("Home", true).has_value());
+			Assert::IsTrue(env.exists("EMPTY") && env.get("EMPTY")->empty());
+			const auto list{ env.list("PATH", ':') };
+			Assert::IsTrue(std::vector<std::string_view>{ list.begin(), list.end() } == std::vector<std::string_view>{ "/usr/bin", "", "/bin" });
+			Assert::AreEqual(size_t{ 3u }, list.size());
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_env_builder()
+	{
+		try {
+			char path[]{ "PATH=/usr/bin" }, home[]{ "HOME=/root" }, lang[]{ "LANG=en_US" };
+			char* envp[]{ path, home, lang, nullptr };
+			opt::EnvBuilder env{ envp, true };
+			env.set("LANG", "C").unset("HOME").prepend_list("PATH", "/opt/bin", ':').append_list("EXTRA", "x", ':');
+			Assert::IsFalse(env.exists("HOME"));
+			Assert::IsTrue(env.get("PATH") == "/opt/bin:/usr/bin");
+			opt::CStringArray block;
+			char** out{ env.build(block) };
+			Assert::AreEqual(size_t{ 3u }, block.size());
+			Assert::AreEqual(std::string{ "PATH=/opt/bin:/usr/bin" }, std::string{ out[0] });
+			Assert::AreEqual(std::string{ "LANG=C" }, std::string{ out[1] });
+			Assert::AreEqual(std::string{ "EXTRA=x" }, std::string{ out[2] });
+			Assert::IsTrue(out[3] == nullptr);
+			const auto* prev{ block.data() };
+			env.unset("EXTRA");
+			Assert::IsTrue(env.build(block) == prev); // the allocation is reused
+			Assert::AreEqual(size_t{ 2u }, block.size());
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_render_argv()
+	{
+		try {
+			// renders args, then checks that the output is the expected argv & parses to the same arguments
+			const auto roundtrip{ [](const opt::ContainerType& args, const opt::ParserConfig& cfg, const std::vector<std::string_view>& expected, const auto& filter) {
+				const auto block{ opt::render_argv(args, filter) };
+				Assert::IsTrue(std::vector<std::string_view>{ block.begin(), block.end() } == expected);
+				const auto reparsed{ opt::parseArgs(std::vector<std::string>{ expected.begin(), expected.end() }, cfg) };
+				std::vector<opt::VariantArgument> kept;
+				std::copy_if(args.begin(), args.end(), std::back_inserter(kept), filter);
+				Assert::AreEqual(kept.size(), reparsed.size());
+				for (size_t i{ 0u }; i < kept.size(); ++i) {
+					Assert::IsTrue(kept[i].type() == reparsed[i].type());
+					Assert::IsTrue(kept[i].name_view() == reparsed[i].name_view());
+					Assert::IsTrue(kept[i].capture() == reparsed[i].capture());
+				}
+			} };
+			const auto all{ [](const opt::VariantArgument&) { return true; } };
+			const auto except{ [](const std::string_view names) { return [names](const opt::VariantArgument& arg) { return names.find(arg.name_view()) == std::string_view::npos; }; } };
+
+			const opt::ParserConfig cfg{ { "b", "opt" } };
+			const auto cont{ opt::parseArgs(std::vector<std::string>{ "-abc", "val", "-d", "--opt", "x", "file", "-5" }, cfg) };
+			opt::CStringArray block;
+			opt::render_argv(block, cont, std::optional<std::string_view>{ "prog" });
+			const std::vector<std::string_view> expected{ "prog", "-abc", "val", "-d", "--opt", "x", "file", "-5" };
+			Assert::IsTrue(std::vector<std::string_view>{ block.begin(), block.end() } == expected);
+			Assert::IsTrue(block.data()[expected.size()] == nullptr);
+			roundtrip(cont, cfg, { expected.begin() + 1, expected.end() }, all);
+			// filtering removes captures along with their option or flag
+			roundtrip(cont, cfg, { "-ac", "-d", "file", "-5" }, except("b-opt"));
+			// clusters are kept intact, & each flag's capture follows its cluster
+			const auto separate{ opt::parseArgs(std::vector<std::string>{ "-ab", "-c" }) };
+			roundtrip(separate, {}, { "-ab", "-c" }, all);
+			const opt::ParserConfig capture_o{ { "o" } };
+			const auto digits{ opt::parseArgs(std::vector<std::string>{ "-ao1", "x", "-a1", "-2b", "-b", "-c0x" }, capture_o) };
+			roundtrip(digits, capture_o, { "-ao1", "x", "-a1", "-2b", "-b", "-c0x" }, all);
+			// clusters that would be parsed as a number or an option are joined to a neighbouring cluster, or rejected when there isn't one
+			roundtrip(digits, capture_o, { "-112b", "-b0x" }, except("aoc"));
+			const auto numbers{ opt::parseArgs(std::vector<std::string>{ "-a1", "-2b", "-c", "-a-" }) };
+			roundtrip(numbers, {}, { "-12b", "-c-" }, except("a"));
+			bool threw{ false };
+			try {
+				(void)opt::render_argv(numbers, except("abc-"));
+			} catch (const std::runtime_error&) { threw = true; }
+			Assert::IsTrue(threw);
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_fingerprint()
+	{
+		try {
+			const opt::ParserConfig cfg{ { "o" } };
+			const opt::ParamsAPI a{ std::vector<std::string>{ "-hv", "--o", "x", "f1", "f2" }, cfg };
+			const opt::ParamsAPI b{ std::vector<std::string>{ "--o", "x", "f1", "-v", "-h", "f2" }, cfg };
+			const opt::ParamsAPI c{ std::vector<std::string>{ "-hv", "--o", "x", "f2", "f1" }, cfg };
+			Assert::AreNotEqual(a.fingerprint(), b.fingerprint());
+			Assert::AreEqual(a.fingerprint(true), b.fingerprint(true));
+			Assert::AreNotEqual(a.fingerprint(true), c.fingerprint(true)); // parameter order still matters
+			const opt::ContainerType cont{ a };
+			Assert::AreEqual(a.fingerprint(), static_cast<uint64_t>(std::hash<opt::ContainerType>{}(cont)));
+			Assert::AreEqual(a.fingerprint(true), opt::ParamsAPI{ opt::ContainerType{ cont } }.fingerprint(true)); // parsed & moved-in containers are fingerprinted alike
+			Assert::AreEqual(cont.front().fingerprint(), static_cast<uint64_t>(std::hash<opt::VariantArgument>{}(cont.front())));
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_canonicalize()
+	{
+		try {
+			const opt::ParserConfig cfg{ { "o" } };
+			const opt::ParamsAPI a{ std::vector<std::string>{ "-hv", "--o", "x", "f1", "f2" }, cfg };
+			const opt::ParamsAPI b{ std::vector<std::string>{ "--o", "x", "f1", "-v", "-h", "-h", "--o", "y", "f2" }, cfg }; // repeated arguments, the first one wins
+			const opt::ParamsAPI c{ std::vector<std::string>{ "-hv", "--o", "x", "f2", "f1" }, cfg };
+			Assert::IsTrue(a == b);
+			Assert::IsFalse(a == c); // parameter order still matters
+			Assert::AreEqual(a.canonical_fingerprint(), b.canonical_fingerprint());
+			const auto canonical{ opt::canonicalize(static_cast<opt::ContainerType>(b)) };
+			Assert::AreEqual(size_t{ 5u }, canonical.size());
+			Assert::IsTrue(canonical[0].name_view() == "o" && canonical[0].capture() == "x");
+			Assert::IsTrue(canonical[1].name_view() == "h" && canonical[2].name_view() == "v");
+			Assert::IsTrue(canonical[3].name_view() == "f1" && canonical[4].name_view() == "f2");
+			// canonically equal instances answer first-match queries the same way
+			Assert::IsTrue(a.getv("o") == b.getv("o"));
+			const opt::ParamsAPI last{ std::vector<std::string>{ "--o", "y", "f1", "-hv", "--o", "x", "f2" }, cfg };
+			Assert::IsFalse(a == last);
+			Assert::IsFalse(a.getv("o") == last.getv("o"));
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_diff()
+	{
+		try {
+			const opt::ParserConfig cfg{ { "o" } };
+			const opt::ParamsAPI a{ std::vector<std::string>{ "-hv", "--o", "x", "f1", "--z" }, cfg };
+			const opt::ParamsAPI b{ std::vector<std::string>{ "--o", "y", "f1", "-v", "f2" }, cfg };
+			Assert::IsTrue(a.diff(a).empty());
+			using enum opt::EditKind;
+			constexpr auto npos{ opt::ArgEdit::npos };
+			const std::vector<opt::ArgEdit> expected{
+				{ CHANGED, opt::Type::OPTION, 2u, 0u },
+				{ ADDED, opt::Type::PARAMETER, npos, 3u },
+				{ REMOVED, opt::Type::FLAG, 0u, npos },
+				{ REMOVED, opt::Type::OPTION, 4u, npos },
+			};
+			Assert::IsTrue(a.diff(b) == expected);
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+	inline int test_instrument_allocations()
+	{
+		try {
+			using enum opt::instrument::EntryPoint;
+			opt::instrument::reset_stats();
+			{
+				const opt::instrument::Scope outer{ FIND };
+				opt::instrument::on_allocate(100u);
+				opt::instrument::on_allocate(50u);
+				opt::instrument::on_deallocate(100u);
+				{
+					const opt::instrument::Scope inner{ CHECK };
+					opt::instrument::on_allocate(200u);
+					opt::instrument::on_deallocate(200u);
+				}
+				opt::instrument::on_deallocate(50u);
+			}
+			const auto find{ opt::instrument::get_stats(FIND) }, check{ opt::instrument::get_stats(CHECK) };
+			Assert::AreEqual(uint64_t{ 1u }, find.calls);
+			Assert::AreEqual(uint64_t{ 3u }, find.allocations); // nested scopes are included in the totals of their callers
+			Assert::AreEqual(uint64_t{ 350u }, find.bytes);
+			Assert::AreEqual(uint64_t{ 250u }, find.peak_bytes);
+			Assert::AreEqual(uint64_t{ 1u }, check.allocations);
+			Assert::AreEqual(uint64_t{ 200u }, check.peak_bytes);
+			Assert::AreEqual(uint64_t{ 0u }, opt::instrument::get_stats(GETV).calls);
+			opt::instrument::reset_stats();
+			Assert::AreEqual(uint64_t{ 0u }, opt::instrument::get_stats(FIND).bytes);
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+	inline int test_trace()
+	{
+		try {
+			char buffer[1024];
+			std::string_view json;
+			{
+				opt::trace::TraceBuffer trace{ buffer, sizeof(buffer) };
+				Assert::IsTrue(opt::trace::TraceBuffer::active() == &trace);
+				{
+					const opt::trace::Phase phase{ "outer" };
+					opt::trace::AggregatePhase aggregate{ "inner" };
+					{ const opt::trace::AggregatePhase::Interval interval{ aggregate }; }
+					{ const opt::trace::AggregatePhase::Interval interval{ aggregate }; }
+				}
+				json = trace.finish();
+				Assert::IsFalse(trace.overflowed());
+			}
+			Assert::IsTrue(opt::trace::TraceBuffer::active() == nullptr);
+			Assert::IsTrue(json.front() == '[' && json.back() == ']');
+			Assert::IsTrue(json.find("{\"name\":\"inner\",\"cat\":\"opt\",\"ph\":\"X\"") != std::string_view::npos);
+			Assert::IsTrue(json.find("\"args\":{\"count\":2}") != std::string_view::npos);
+			Assert::IsTrue(json.find("{\"name\":\"outer\"") > json.find("{\"name\":\"inner\"")); // events are written when they end
+
+			// buffers may be finished in any order, & the newest unfinished one stays active
+			{
+				char first_buffer[64], second_buffer[64];
+				std::optional<opt::trace::TraceBuffer> first;
+				first.emplace(first_buffer, sizeof(first_buffer));
+				const opt::trace::TraceBuffer second{ second_buffer, sizeof(second_buffer) };
+				first.reset();
+				Assert::IsTrue(opt::trace::TraceBuffer::active() == &second);
+			}
+			Assert::IsTrue(opt::trace::TraceBuffer::active() == nullptr);
+
+			// phases may end on other threads while a buffer is being destroyed
+			{
+				std::atomic<bool> stop{ false };
+				std::thread worker{ [&stop]() {
+					while (!stop.load())
+						const opt::trace::Phase phase{ "worker" };
+				} };
+				for (int i{ 0 }; i < 1000; ++i) {
+					char worker_buffer[256];
+					const opt::trace::TraceBuffer trace{ worker_buffer, sizeof(worker_buffer) };
+				}
+				stop = true;
+				worker.join();
+			}
+
+			char small[8];
+			opt::trace::TraceBuffer trace{ small, sizeof(small) };
+			{ const opt::trace::Phase phase{ "outer" }; }
+			Assert::AreEqual(size_t{ 8u }, trace.finish().size());
+			Assert::IsTrue(trace.overflowed() && trace.size() > sizeof(small));
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+	inline int test_parse_stats()
+	{
+		try {
+			opt::ParseStats stats;
+			const opt::ParamsAPI args{ std::vector<std::string>{ "-hv", "--o", "x", "-5", "-0x1F", "-", "-0x", "p1", "--long-option-name-that-does-not-fit-in-a-small-string" }, opt::ParserConfig{ { "o" } }, std::nullopt, &stats };
+			Assert::AreEqual(size_t{ 5u }, stats.parameters);
+			Assert::AreEqual(size_t{ 2u }, stats.count(opt::Type::OPTION));
+			Assert::AreEqual(size_t{ 2u }, stats.flags);
+			Assert::AreEqual(size_t{ 1u }, stats.captures);
+			Assert::AreEqual(size_t{ 1u }, stats.flag_clusters);
+			Assert::AreEqual(2.0, stats.average_cluster_length());
+			Assert::AreEqual(size_t{ 2u }, stats.negative_numbers); // "-" & "-0x" are parameters, but not numbers
+			Assert::AreEqual(size_t{ 68u }, stats.name_bytes);
+			Assert::AreEqual(size_t{ 1u }, stats.capture_bytes);
+			Assert::AreEqual(size_t{ 9u }, stats.size);
+			Assert::IsTrue(stats.capacity >= stats.size);
+			Assert::IsTrue(stats.heap_bytes > 0u); // the long option name doesn't fit in the small string buffer
+			Assert::AreEqual(stats.capacity * sizeof(opt::VariantArgument) + stats.heap_bytes, stats.footprint_bytes());
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+	inline int test_query_index()
+	{
+		try {
+			std::vector<std::string> vec{ "-hv", "--o", "x", "p1", "-o", "y", "--name", "p2", "-h", "--o", "z" };
+			for (int i{ 0 }; i < 10; ++i)
+				vec.emplace_back("--opt" + std::to_string(i));
+			const opt::ParserConfig cfg{ { "o" } };
+			opt::ParamsAPI scanned{ std::vector<std::string>{ vec }, cfg }, indexed{ std::move(vec), cfg };
+			scanned.configure_index(opt::AdaptiveIndex::NEVER);
+			indexed.configure_index(4u);
+			for (int repeat{ 0 }; repeat < 3; ++repeat) {
+				for (const std::string name : { "h", "v", "o", "x", "p1", "p2", "name", "opt9", "missing" }) {
+					Assert::IsTrue(scanned.find(name) - scanned.begin() == indexed.find(name) - indexed.begin());
+					Assert::IsTrue(scanned.find<opt::Option>(name) - scanned.begin() == indexed.find<opt::Option>(name) - indexed.begin());
+					Assert::IsTrue(scanned.find<opt::Flag>(name) - scanned.begin() == indexed.find<opt::Flag>(name) - indexed.begin());
+					Assert::IsTrue(scanned.getv(name, scanned.begin() + 3) == indexed.getv(name, indexed.begin() + 3));
+				}
+			}
+			Assert::IsTrue(indexed.check_flag('h') && !indexed.check_flag('x'));
+			const auto profile{ indexed.query_profile() };
+			Assert::IsTrue(profile.indexed);
+			Assert::AreEqual(uint64_t{ 2u }, profile.checks);
+			Assert::AreEqual(uint64_t{ 27u }, profile.getvs);
+			Assert::AreEqual(uint64_t{ 110u }, profile.finds);
+			Assert::AreEqual(uint64_t{ 4u }, profile.scans);
+			Assert::AreEqual(uint64_t{ 106u }, profile.index_hits);
+			Assert::IsFalse(scanned.query_profile().indexed);
+			const opt::ParamsAPI copy{ indexed };
+			Assert::IsFalse(copy.query_profile().indexed); // copies start over, because the index refers to the original container
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_env_builder_growth()
+	{
+		try {
+			opt::EnvBuilder env{ opt::EnvView{}, true };
+			for (int i{ 0 }; i < 1000; ++i)
+				env.set("VAR" + std::to_string(i), std::to_string(i));
+			for (int i{ 0 }; i < 1000; i += 7)
+				Assert::IsTrue(env.get("VAR" + std::to_string(i)) == std::to_string(i));
+			Assert::IsFalse(env.exists("VAR1000"));
+			env.set("VAR0", "first");
+			opt::CStringArray block;
+			char** out{ env.build(block) };
+			Assert::AreEqual(size_t{ 1000u }, block.size());
+			Assert::AreEqual(std::string{ "VAR0=first" }, std::string{ out[0] }); // setting an existing variable keeps its position
+			// overwriting a variable reuses its storage, including after it has been unset
+			const auto owned{ env.owned_strings() };
+			for (int i{ 0 }; i < 1000; ++i)
+				env.set("VAR1", std::to_string(i)).unset("VAR1").append_list("VAR1", "x", ':').prepend_list("VAR1", "y", ':');
+			Assert::AreEqual(owned, env.owned_strings());
+			Assert::IsTrue(env.get("VAR1") == "y:x");
+			char path[]{ "PATH=/usr/bin" };
+			char* envp[]{ path, nullptr };
+			opt::EnvBuilder from_snapshot{ envp, true };
+			for (int i{ 0 }; i < 1000; ++i)
+				from_snapshot.prepend_list("PATH", "/opt/bin", ':').set("PATH", "/usr/bin");
+			Assert::AreEqual(size_t{ 1u }, from_snapshot.owned_strings()); // the name still refers to the snapshot
+			Assert::IsTrue(from_snapshot.get("PATH") == "/usr/bin");
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+	inline int test_serialize_json()
+	{
+		try {
+			// JSON output includes types & captures, & escapes strings
+			const opt::ContainerType args{ opt::VariantArgument{ std::make_pair('a', std::optional<std::string>{ "say \"hi\"\n" }) }, opt::VariantArgument{ std::string{ "file" } } };
+			const auto json{ opt::serialize_json(args) };
+			Assert::AreEqual(std::string{ R"([{"type":"FLAG","name":"a","capture":"say \"hi\"\n"},{"type":"PARAMETER","name":"file"}])" }, json);
+			// well-formed UTF-8 is copied, & bytes that aren't are replaced so the output is still valid JSON
+			Assert::AreEqual(std::string{ "[{\"type\":\"PARAMETER\",\"name\":\"caf\xC3\xA9 \xF0\x9F\x98\x80\"}]" }, opt::serialize_json(opt::ContainerType{ opt::VariantArgument{ std::string{ "caf\xC3\xA9 \xF0\x9F\x98\x80" } } }));
+			Assert::AreEqual(std::string{ R"([{"type":"PARAMETER","name":"a\ufffdb\ufffd\ufffd\ufffdc\ufffd\ufffd"}])" }, opt::serialize_json(opt::ContainerType{ opt::VariantArgument{ std::string{ "a\xFF" "b\xC0\xAF\xED" "c\xE2\x82" } } }));
+			// writing into a caller-provided buffer matches the std::string output, & reports the required size when it doesn't fit
+			const auto buffer{ opt::serialize(args) };
+			std::string direct(buffer.size(), '\0');
+			Assert::AreEqual(buffer.size(), opt::serialize(direct.data(), direct.size(), args));
+			Assert::IsTrue(direct == buffer);
+			Assert::AreEqual(buffer.size(), opt::serialize(nullptr, 0u, args));
+			char small[8];
+			Assert::AreEqual(json.size(), opt::serialize_json(small, sizeof(small), args));
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+	inline int test_parse_flag_cluster()
+	{
+		try {
+			// a single long flag cluster with a capturing flag at the end
+			const opt::ParserConfig cfg{ { "o" } };
+			const auto cont{ opt::parseArgs(std::vector<std::string>{ "-" + std::string(1000u, 'a') + "o", "value" }, cfg) };
+			Assert::AreEqual(size_t{ 1001u }, cont.size());
+			Assert::IsTrue(cont.front().name_view() == "a" && !cont.front().hasv());
+			Assert::IsTrue(cont.back().name_view() == "o" && cont.back().capture() == "value");
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_allow_capture_char()
+	{
+		try {
+			// single-character names in the capture list apply to flags, & longer names don't
+			const opt::ParserConfig cfg{ { "o", "-", "ab" } };
+			Assert::IsTrue(cfg.allowCapture('o'));
+			Assert::IsFalse(cfg.allowCapture('-')); // delimiters are removed as a prefix before comparing
+			Assert::IsFalse(cfg.allowCapture('a'));
+			Assert::IsFalse(cfg.allowCapture('b'));
+			Assert::IsTrue(cfg.allowCapture("ab"));
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_resolve_path_scan()
+	{
+		try {
+			const utils::TempDir tmp{ "opt-resolve-path-scan" };
+			tmp.touch("b/opt-test-exe");
+			std::filesystem::create_directories(tmp.path / "a");
+			std::string path_var{ "PATH=" + tmp.dir("a") + opt::ENV_LIST_SEPARATOR + opt::ENV_LIST_SEPARATOR + tmp.dir("b") };
+			char home[]{ "HOME=/root" };
+			char* envp[]{ home, path_var.data(), nullptr };
+			// PATH is split on the platform's list separator, & empty elements are skipped
+			Assert::IsTrue(opt::path_list(opt::EnvView{ envp }) == std::vector<std::string>{ tmp.dir("a"), tmp.dir("b") });
+			const auto expected{ tmp.dir("b") + '/' };
+			Assert::IsTrue(opt::resolve_split_path(envp, "opt-test-exe") == std::pair<std::string, std::string>{ expected, "opt-test-exe" });
+			// the fallback used by resolve_executable(char**, ...) when /proc/self/exe & argv[0] can't be used
+			const auto found{ opt::resolve_executable_in_path(opt::path_list(opt::EnvView{ envp }), "opt-test-exe") };
+			Assert::IsTrue(found.strategy == opt::ResolveStrategy::PATH_SCAN);
+			Assert::AreEqual(expected, found.path);
+			Assert::AreEqual(std::string{ "opt-test-exe" }, found.name);
+			const auto missing{ opt::resolve_executable_in_path(opt::path_list(opt::EnvView{ envp }), "opt-missing-exe") };
+			Assert::IsTrue(missing.strategy == opt::ResolveStrategy::NONE && missing.path.empty());
+			// a missing PATH variable is an empty list, not an error
+			char* no_path[]{ home, nullptr };
+			Assert::IsTrue(opt::path_list(opt::EnvView{ no_path }).empty());
+			Assert::IsTrue(opt::resolve_executable(no_path, "opt-missing-exe").strategy != opt::ResolveStrategy::PATH_SCAN);
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_startup_context()
+	{
+		try {
+			char path[]{ "PATH=/usr/bin" }, home[]{ "HOME=/root" }, arg0[]{ "opt-missing-exe" };
+			char* envp[]{ path, home, nullptr };
+			char* argv[]{ arg0, nullptr };
+			for (const auto policy : { std::launch::async, std::launch::deferred }) {
+				const opt::StartupContext startup{ argv, envp, policy };
+				if (policy == std::launch::deferred) // nothing runs until it is requested
+					Assert::IsFalse(startup.env_view_ready() || startup.env_ready() || startup.executable_ready());
+				Assert::IsTrue(startup.env_view().get("HOME") == "/root");
+				Assert::IsTrue(std::vector<std::string_view>{ startup.env_view().PATH().begin(), startup.env_view().PATH().end() } == std::vector<std::string_view>{ "/usr/bin" });
+				Assert::IsTrue(startup.env().exists("HOME") && startup.env().exists("PATH"));
+				const auto& exe{ startup.executable() };
+			#ifdef __linux__
+				Assert::IsTrue(exe.strategy == opt::ResolveStrategy::SELF_EXE);
+			#else
+				Assert::IsTrue(exe.strategy == opt::ResolveStrategy::NONE);
+			#endif
+				Assert::IsTrue(startup.env_view_ready() && startup.env_ready() && startup.executable_ready());
+			}
+			// a null argv is treated as an empty argv[0]
+			const opt::StartupContext no_argv{ nullptr, envp, std::launch::deferred };
+			Assert::IsTrue(no_argv.env_view().size() == 2u);
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_resolve_path_cache()
+	{
+		try {
+			const utils::TempDir tmp{ "opt-resolve-path-cache" };
+			const auto cache{ tmp.path / "cache" / "resolve.cache" };
+			const auto read_lines{ [&cache]() {
+				std::vector<std::string> lines;
+				std::ifstream file{ cache };
+				for (std::string ln; std::getline(file, ln); lines.emplace_back(ln)) {}
+				return lines;
+			} };
+			std::filesystem::create_directories(tmp.path / "a");
+			tmp.touch("b/tool");
+			const std::vector<std::string> PATH{ tmp.dir("a"), tmp.dir("b") };
+			const std::pair<std::string, std::string> in_a{ tmp.dir("a") + '/', "tool" }, in_b{ tmp.dir("b") + '/', "tool" };
+
+			// a miss walks PATH & stores the result
+			Assert::IsTrue(opt::resolve_split_path_cached(PATH, "tool", cache) == in_b);
+			Assert::AreEqual(size_t{ 1u }, read_lines().size());
+			// a hit is returned without walking PATH, so a new match in an earlier directory isn't seen
+			tmp.touch("a/tool");
+			Assert::IsTrue(opt::resolve_split_path(PATH, "tool") == in_a);
+			Assert::IsTrue(opt::resolve_split_path_cached(PATH, "tool", cache) == in_b);
+			// a stale hit falls back to the PATH walk, & the stale entry is replaced
+			std::filesystem::remove(tmp.path / "b" / "tool");
+			Assert::IsTrue(opt::resolve_split_path_cached(PATH, "tool", cache) == in_a);
+			const auto lines{ read_lines() };
+			Assert::AreEqual(size_t{ 1u }, lines.size());
+			Assert::IsTrue(lines.front().ends_with(tmp.dir("a") + "/\ttool"));
+			// names that weren't found, or that contain a tab or newline, are not cached
+		#ifndef _WIN32 // tabs & newlines aren't valid in Windows filenames
+			tmp.touch("b/tab\tname");
+			tmp.touch("b/line\nname");
+			Assert::IsTrue(opt::resolve_split_path_cached(PATH, "tab\tname", cache) == std::pair<std::string, std::string>{ tmp.dir("b") + '/', "tab\tname" });
+			Assert::IsTrue(opt::resolve_split_path_cached(PATH, "line\nname", cache) == std::pair<std::string, std::string>{ tmp.dir("b") + '/', "line\nname" });
+		#endif
+			Assert::IsTrue(opt::resolve_split_path_cached(PATH, "missing", cache) == std::pair<std::string, std::string>{ {}, "missing" });
+			Assert::AreEqual(size_t{ 1u }, read_lines().size());
+
+			// a full cache discards its oldest entries
+			{
+				std::ofstream file{ cache, std::ios::trunc };
+				for (size_t i{ 0u }; i < opt::RESOLVE_CACHE_MAX_ENTRIES; ++i)
+					file << "ffffffff" << std::setw(8) << std::setfill('0') << i << "\t/nonexistent/\tentry" << i << '\n';
+			}
+			Assert::IsTrue(opt::resolve_split_path_cached(PATH, "tool", cache) == in_a);
+			const auto trimmed{ read_lines() };
+			Assert::AreEqual(opt::RESOLVE_CACHE_MAX_ENTRIES, trimmed.size());
+			Assert::IsTrue(trimmed.front().ends_with("\tentry1"));
+			Assert::IsTrue(trimmed[trimmed.size() - 2u].ends_with("\tentry" + std::to_string(opt::RESOLVE_CACHE_MAX_ENTRIES - 1u)));
+			Assert::IsTrue(trimmed.back().ends_with(tmp.dir("a") + "/\ttool"));
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_resolve_paths()
+	{
+		try {
+			const utils::TempDir tmp{ "opt-resolve-paths" };
+			tmp.touch("a/both");
+			tmp.touch("a/script.bat");
+			tmp.touch("b/both");
+			tmp.touch("b/tool");
+			tmp.touch("b/lib.so");
+			const std::vector<std::string> PATH{ tmp.dir("a"), tmp.dir("missing-dir"), tmp.dir("b") };
+			const std::vector<std::string> names{ "tool", "both", "script", "lib", "missing", "", "./tool", "../b/tool", (tmp.path / "b" / "tool").string(), "sub/tool" };
+			for (const bool parallel : { false, true }) {
+				const auto results{ opt::resolve_split_paths(PATH, names, { ".exe", ".bat", ".so" }, parallel) };
+				Assert::AreEqual(names.size(), results.size());
+				for (size_t i{ 0u }; i < names.size(); ++i)
+					Assert::IsTrue(results[i] == opt::resolve_split_path(PATH, names[i]));
+			}
+			Assert::IsTrue(opt::resolve_split_paths(PATH, names)[1] == std::pair<std::string, std::string>{ tmp.dir("a") + '/', "both" }); // the first directory wins
+			Assert::IsTrue(opt::resolve_split_paths(PATH, names)[2] == std::pair<std::string, std::string>{ tmp.dir("a") + '/', "script.bat" });
+			Assert::IsTrue(opt::resolve_split_paths(PATH, names)[4] == std::pair<std::string, std::string>{ {}, "missing" });
+			Assert::IsTrue(opt::resolve_split_paths(PATH, {}).empty());
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
+
+	inline int test_frozen_memfd()
+	{
+		try {
+		#ifdef __linux__
+			const opt::ParamsAPI args{ utils::make_args<opt::ParamsAPI>(utils::default_commandline) };
+			const opt::ContainerType original{ args.begin(), args.end() };
+			const int fd{ opt::freeze_to_memfd(args) };
+			Assert::IsTrue(fd != -1);
+			{
+				const opt::MappedFile file{ fd };
+				const opt::FrozenParams frozen{ file.view() };
+				Assert::AreEqual(original.size(), frozen.size());
+				Assert::IsTrue(frozen.check_flag('h'));
+				Assert::IsTrue(frozen.check_opt("test-inner-dash"));
+				Assert::IsTrue(frozen.check_param("-1024"));
+				const auto thawed{ frozen.thaw() };
+				Assert::IsTrue(opt::ContainerType{ thawed.begin(), thawed.end() } == original);
+			}
+			// the memfd is sealed, so it can't be modified after it has been frozen
+			Assert::IsTrue(::write(fd, "x", 1u) == -1);
+			Assert::IsTrue(::ftruncate(fd, 0) == -1);
+			::close(fd);
+			// a memfd that doesn't allow sealing fails & is closed
+			const int unsealable{ memfd_create("opt-frozen-params-test", MFD_CLOEXEC) };
+			Assert::IsTrue(unsealable != -1);
+			Assert::AreEqual(-1, opt::seal_snapshot(unsealable, opt::freeze(args)));
+			Assert::IsTrue(fcntl(unsealable, F_GETFD) == -1 && errno == EBADF);
+		#endif
+			return 0;
+		} catch ( ... ) { return -1; }
+	}
 }
\ No newline at end of file
@@ -1,7 +1,21 @@
 #pragma once
 #include <Params.hpp>
 #include <ParamsAPI.hpp>
+#include <parseResponseFile.hpp>
+#include <FrozenParams.hpp>
+#include <parseCmdline.hpp>
+#include <EnvView.hpp>
+#include <EnvBuilder.hpp>
+#include <render-argv.hpp>
+#include <resolve-path.hpp>
+#include <StartupContext.hpp>
+#include <instrument-allocations.hpp>
+#include <trace-phases.hpp>
 #include "pch.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 namespace utils {
 	inline std::streambuf* swap_stream(std::ostream& os, std::streambuf* newBuffer)
 	{
@@ -53,6 +67,32 @@ namespace utils {
 		return NULL_TYPE;
 	}
 
+	/// @brief A uniquely-named directory under the system's temporary directory, which is removed with its contents on destruction.
+	struct TempDir {
+		std::filesystem::path path;
+
+		explicit TempDir(const std::string& prefix) : path{ std::filesystem::temp_directory_path() / ( prefix + '-' + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) ) }
+		{
+			std::filesystem::create_directories(path);
+		}
+		~TempDir()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(path, ec);
+		}
+
+		/// @brief Create an empty file at the given path relative to this directory, creating any missing parent directories.	@returns std::filesystem::path
+		std::filesystem::path touch(const std::filesystem::path& name) const
+		{
+			const auto file{ path / name };
+			std::filesystem::create_directories(file.parent_path());
+			std::ofstream{ file };
+			return file;
+		}
+		/// @brief Retrieve the path to the given subdirectory as a string.	@returns std::string
+		std::string dir(const std::string& name) const { return ( path / name ).string(); }
+	};
+
 	template<class ParamType>
 	constexpr bool is_params()
 	{
@@ -0,0 +1,197 @@
+/**
+ * @file ArgIndex.hpp
+ * @author radj307
+ * @brief Contains the ArgIndex class, a hashed index of parsed arguments, & the AdaptiveIndex class, which profiles queries & builds an ArgIndex once they become frequent.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <parseArgs.hpp>
+#include <trace-phases.hpp>
+
+namespace opt {
+	/**
+	 * @class ArgIndex
+	 * @brief Hashed index of the names in an argument container, with a bitmap of the flags that are present.
+	 *\n	  The index stores views of the names in the container, so the container's elements must not be modified or reallocated while it is in use.
+	 *\n	  Moving the container itself is allowed, since that doesn't move its elements.
+	 */
+	class ArgIndex {
+		struct Hash {
+			using is_transparent = void;
+			size_t operator()(const std::string_view str) const noexcept { return static_cast<size_t>(fnv1a(str)); }
+		};
+
+		std::unordered_map<std::string_view, std::vector<uint32_t>, Hash, std::equal_to<>> _positions;	///< @brief Positions of every argument with each name, in ascending order.
+		std::bitset<256> _flags;	///< @brief Set for each flag character that appears in the container.
+
+	public:
+		/**
+		 * @brief Constructor that indexes an argument container.
+		 * @param cont	- Argument container.
+		 */
+		explicit ArgIndex(const ContainerType& cont)
+		{
+			OPT_TRACE_PHASE(trace::phase::INDEX);
+			_positions.reserve(cont.size());
+			for (uint32_t pos{ 0u }; pos < cont.size(); ++pos) {
+				const auto& arg{ cont[pos] };
+				const auto name{ arg.name_view() };
+				_positions[name].emplace_back(pos);
+				if (arg.type() == Type::FLAG)
+					_flags.set(static_cast<unsigned char>(name.front()));
+			}
+		}
+
+		/**
+		 * @brief Check if a flag appears in the indexed container.
+		 * @param flag	- Flag character.
+		 * @returns bool
+		 */
+		[[nodiscard]] bool has_flag(const char flag) const noexcept { return _flags.test(static_cast<unsigned char>(flag)); }
+
+		/**
+		 * @brief Find the first argument with a given name, & optionally a given type, at or after a position.
+		 * @param cont	- The indexed container.
+		 * @param name	- Name to search for.
+		 * @param type	- When specified, only arguments of this type are matched.
+		 * @param off	- Position to begin searching at.
+		 * @returns size_t	- The position of the argument, or the size of the container if it wasn't found.
+		 */
+		[[nodiscard]] size_t find(const ContainerType& cont, const std::string_view name, const std::optional<Type>& type, const size_t off = 0u) const
+		{
+			if (type == Type::FLAG && (name.size() != 1u || !has_flag(name.front())))
+				return cont.size();
+			const auto it{ _positions.find(name) };
+			if (it == _positions.end())
+				return cont.size();
+			for (auto pos{ std::lower_bound(it->second.begin(), it->second.end(), static_cast<uint32_t>(off)) }; pos != it->second.end(); ++pos)
+				if (!type.has_value() || cont[*pos].type() == type.value())
+					return *pos;
+			return cont.size();
+		}
+	};
+
+	/**
+	 * @struct QueryProfile
+	 * @brief Snapshot of the queries served by a ParamsAPI instance.
+	 */
+	struct QueryProfile {
+		uint64_t finds{ 0u };		///< @brief Number of lookups, including those made by check() & getv().
+		uint64_t checks{ 0u };		///< @brief Number of calls to check().
+		uint64_t getvs{ 0u };		///< @brief Number of calls to getv().
+		uint64_t scans{ 0u };		///< @brief Number of lookups that were served by a linear scan.
+		uint64_t index_hits{ 0u };	///< @brief Number of lookups that were served by the index.
+		bool indexed{ false };		///< @brief True when the index has been built.
+	};
+
+	/**
+	 * @class AdaptiveIndex
+	 * @brief Counts the queries made on an argument container, & builds an ArgIndex once the number of lookups reaches a threshold.
+	 *\n	  Containers smaller than a minimum size are never indexed, because a linear scan is faster than hashing for a few arguments.
+	 *\n	  Counting & building are thread-safe, so const queries can still be made from several threads at once.
+	 *\n	  Copies start with no index & no counters, because the index refers to the container that it was built from.
+	 */
+	class AdaptiveIndex {
+		mutable std::atomic<uint64_t> _finds{ 0u }, _checks{ 0u }, _getvs{ 0u }, _index_hits{ 0u };
+		mutable std::atomic<const ArgIndex*> _index{ nullptr };
+		size_t _threshold{ DEFAULT_THRESHOLD };
+		size_t _min_size{ DEFAULT_MIN_SIZE };
+
+	public:
+		static constexpr size_t DEFAULT_THRESHOLD{ 32u };	///< @brief Default number of lookups after which the index is built.
+		static constexpr size_t DEFAULT_MIN_SIZE{ 16u };	///< @brief Default minimum number of arguments required to build the index.
+		static constexpr size_t NEVER{ std::numeric_limits<size_t>::max() };	///< @brief Threshold that disables the index.
+
+		AdaptiveIndex() = default;
+		AdaptiveIndex(const AdaptiveIndex& o) noexcept : _threshold{ o._threshold }, _min_size{ o._min_size } {}
+		AdaptiveIndex(AdaptiveIndex&& o) noexcept : _finds{ o._finds.load() }, _checks{ o._checks.load() }, _getvs{ o._getvs.load() }, _index_hits{ o._index_hits.load() }, _index{ o._index.exchange(nullptr) }, _threshold{ o._threshold }, _min_size{ o._min_size } {}
+		~AdaptiveIndex() { delete _index.load(); }
+		AdaptiveIndex& operator=(const AdaptiveIndex& o) noexcept
+		{
+			if (this != &o) {
+				reset();
+				_threshold = o._threshold;
+				_min_size = o._min_size;
+			}
+			return *this;
+		}
+		AdaptiveIndex& operator=(AdaptiveIndex&& o) noexcept
+		{
+			if (this != &o) {
+				delete _index.exchange(o._index.exchange(nullptr));
+				_finds = o._finds.load();
+				_checks = o._checks.load();
+				_getvs = o._getvs.load();
+				_index_hits = o._index_hits.load();
+				_threshold = o._threshold;
+				_min_size = o._min_size;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Set when the index is built. This should be called before making queries from several threads.
+		 * @param threshold	- Number of lookups after which the index is built. 0 builds it on the first lookup, & NEVER disables it.
+		 * @param min_size	- Minimum number of arguments required to build the index.
+		 */
+		void configure(const size_t threshold, const size_t min_size = DEFAULT_MIN_SIZE) noexcept
+		{
+			_threshold = threshold;
+			_min_size = min_size;
+		}
+
+		/// @brief Discard the index & reset the counters.
+		void reset() noexcept
+		{
+			delete _index.exchange(nullptr);
+			_finds = 0u;
+			_checks = 0u;
+			_getvs = 0u;
+			_index_hits = 0u;
+		}
+
+		void record_check() const noexcept { _checks.fetch_add(1u, std::memory_order_relaxed); }	///< @brief Count a call to check().
+		void record_getv() const noexcept { _getvs.fetch_add(1u, std::memory_order_relaxed); }		///< @brief Count a call to getv().
+
+		/**
+		 * @brief Count a lookup, & retrieve the index if it should be used for it, building the index if the threshold has been reached.
+		 * @param cont	- The container being searched. This must be the same container for every call.
+		 * @returns const ArgIndex*	- nullptr when the lookup should use a linear scan.
+		 */
+		[[nodiscard]] const ArgIndex* acquire(const ContainerType& cont) const
+		{
+			const auto count{ _finds.fetch_add(1u, std::memory_order_relaxed) };
+			auto* index{ _index.load(std::memory_order_acquire) };
+			if (index == nullptr) {
+				if (count < _threshold || _threshold == NEVER || cont.size() < _min_size)
+					return nullptr;
+				// several threads may build the index at once; only the first to finish keeps theirs
+				const auto* built{ new ArgIndex{ cont } };
+				if (_index.compare_exchange_strong(index, built, std::memory_order_acq_rel))
+					index = built;
+				else delete built;
+			}
+			_index_hits.fetch_add(1u, std::memory_order_relaxed);
+			return index;
+		}
+
+		/**
+		 * @brief Retrieve a snapshot of the query counters.
+		 * @returns QueryProfile
+		 */
+		[[nodiscard]] QueryProfile profile() const noexcept
+		{
+			const auto finds{ _finds.load(std::memory_order_relaxed) }, index_hits{ _index_hits.load(std::memory_order_relaxed) };
+			return{ finds, _checks.load(std::memory_order_relaxed), _getvs.load(std::memory_order_relaxed), finds - index_hits, index_hits, _index.load(std::memory_order_acquire) != nullptr };
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+/**
+ * @file CStringArray.hpp
+ * @author radj307
+ * @brief Contains the CStringArray class, a NULL-terminated array of C strings stored in a single allocation, such as argv or envp.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <array>
+#include <concepts>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace opt {
+	/**
+	 * @class CStringArray
+	 * @brief NULL-terminated array of NUL-terminated strings, suitable for passing to execve / posix_spawn as argv or envp.
+	 *\n	  The pointer array & every string are stored in one contiguous allocation, with the pointers first & the characters after them.
+	 *\n	  Assigning new contents reuses the existing allocation when it is large enough, so a single instance can be reused for every spawn.
+	 */
+	class CStringArray {
+		std::unique_ptr<char* []> _block;	///< @brief Pointer array followed by the string characters.
+		size_t _capacity{ 0u };				///< @brief Size of _block, in pointers.
+		size_t _count{ 0u };				///< @brief Number of strings, not including the terminating NULL.
+
+		/**
+		 * @brief Make sure the block can hold a number of pointers & characters, reallocating only if it can't.
+		 * @param count	- Number of strings.
+		 * @param chars	- Total number of characters, including the NUL terminator of each string.
+		 */
+		void reserve_block(const size_t count, const size_t chars)
+		{
+			const auto required{ count + 1u + (chars + sizeof(char*) - 1u) / sizeof(char*) };
+			if (required > _capacity) {
+				_block = std::make_unique_for_overwrite<char* []>(required);
+				_capacity = required;
+			}
+			_count = count;
+		}
+
+		/// @brief Retrieve a pointer to the first character after the pointer array.
+		char* characters() noexcept { return reinterpret_cast<char*>(_block.get() + _count + 1u); }
+
+	public:
+		/**
+		 * @brief Default Constructor. Creates an empty array. data() returns nullptr until contents are assigned.
+		 */
+		CStringArray() = default;
+		/**
+		 * @brief Constructor that copies a range of strings.
+		 * @param strings	- Any range of elements that are convertible to std::string_view.
+		 */
+		template<class Range> requires (!std::same_as<Range, CStringArray>) explicit CStringArray(const Range& strings) { assign(strings); }
+
+		/**
+		 * @brief Replace the contents with strings written by a function, which is called twice: once with a sink that measures the output, & once with a sink that writes it.
+		 *\n	  The sink has three methods: append(std::string_view), append(char), & end_string(), which terminates the current string & begins the next one.
+		 *\n	  The function must produce identical output both times.
+		 * @param emit	- Function that accepts a sink by reference.
+		 */
+		template<class Fn>
+		void assign_with(Fn&& emit)
+		{
+			struct Measure {
+				size_t count{ 0u }, chars{ 0u };
+				void append(const std::string_view str) noexcept { chars += str.size(); }
+				void append(const char) noexcept { ++chars; }
+				void end_string() noexcept { ++chars; ++count; }
+			} measure;
+			emit(measure);
+			reserve_block(measure.count, measure.chars);
+
+			struct Write {
+				char** ptr;
+				char* out;
+				char* start;
+				void append(const std::string_view str) noexcept
+				{
+					if (!str.empty())
+						std::memcpy(out, str.data(), str.size());
+					out += str.size();
+				}
+				void append(const char ch) noexcept { *out++ = ch; }
+				void end_string() noexcept
+				{
+					*out++ = '\0';
+					*ptr++ = start;
+					start = out;
+				}
+			} write{ _block.get(), characters(), characters() };
+			emit(write);
+			*write.ptr = nullptr;
+		}
+		/**
+		 * @brief Replace the contents with a range of elements, where each string is the concatenation of the pieces returned by a projection.
+		 *\n	  This allows strings such as "NAME=VALUE" to be written directly into the block without being joined beforehand.
+		 * @param range	- Range of elements to copy. This is iterated twice, once to measure & once to copy.
+		 * @param proj	- Function that accepts an element & returns a range of std::string_view pieces.
+		 */
+		template<class Range, class Proj>
+		void assign(Range&& range, Proj&& proj)
+		{
+			assign_with([&range, &proj](auto& sink) {
+				for (const auto& elem : range) {
+					for (const auto& piece : proj(elem))
+						sink.append(piece);
+					sink.end_string();
+				}
+			});
+		}
+		/**
+		 * @brief Replace the contents with a range of strings.
+		 * @param strings	- Any range of elements that are convertible to std::string_view.
+		 */
+		template<class Range>
+		void assign(const Range& strings)
+		{
+			assign(strings, [](const auto& str) { return std::array<std::string_view, 1u>{ std::string_view{ str } }; });
+		}
+
+		/// @brief Remove every string, keeping the allocation.
+		void clear() noexcept
+		{
+			if (_block) {
+				_count = 0u;
+				_block[0] = nullptr;
+			}
+		}
+
+		[[nodiscard]] char** data() noexcept { return _block.get(); }									///< @brief Retrieve the NULL-terminated pointer array.						@returns char**
+		[[nodiscard]] char* const* data() const noexcept { return _block.get(); }						///< @brief Retrieve the NULL-terminated pointer array.						@returns char* const*
+		[[nodiscard]] size_t size() const noexcept { return _count; }									///< @brief Retrieve the number of strings, not including the terminator.	@returns size_t
+		[[nodiscard]] bool empty() const noexcept { return _count == 0u; }								///< @brief Check if there are no strings.									@returns bool
+		[[nodiscard]] size_t capacity_bytes() const noexcept { return _capacity * sizeof(char*); }		///< @brief Retrieve the size of the allocation in bytes.					@returns size_t
+		[[nodiscard]] std::string_view operator[](const size_t pos) const { return _block[pos]; }		///< @brief Retrieve the string at a given index.							@returns std::string_view
+		[[nodiscard]] char* const* begin() const noexcept { return _block.get(); }						///< @brief Retrieve a pointer to the first string pointer.					@returns char* const*
+		[[nodiscard]] char* const* end() const noexcept { return _block.get() + _count; }				///< @brief Retrieve a pointer to one past the last string pointer.			@returns char* const*
+	};
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+/**
+ * @file EnvBuilder.hpp
+ * @author radj307
+ * @brief Contains the EnvBuilder class, which applies edits to a snapshot of the environment & emits an envp array for spawning child processes.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <deque>
+#include <ranges>
+#include <string>
+#include <CStringArray.hpp>
+#include <EnvView.hpp>
+
+namespace opt {
+#ifdef _WIN32
+	inline constexpr bool ENV_CASE_SENSITIVE{ false }; ///< @brief Whether environment variable names are case-sensitive on this platform.
+#else
+	inline constexpr bool ENV_CASE_SENSITIVE{ true }; ///< @brief Whether environment variable names are case-sensitive on this platform.
+#endif
+
+	/**
+	 * @class EnvBuilder
+	 * @brief Builds a modified copy of an environment for execve / posix_spawn.
+	 *\n	  Variables that aren't edited are never copied until build() is called, which writes the whole environment into a CStringArray in a single allocation.
+	 *\n	  Variables keep their original order; new variables are added to the end.
+	 * @code
+	 * opt::EnvBuilder env{ envp };
+	 * env.set("LANG", "C").unset("DISPLAY").prepend_list("PATH", "/opt/tools/bin");
+	 * opt::CStringArray block;
+	 * posix_spawn(&pid, path, nullptr, nullptr, argv, env.build(block));
+	 * @endcode
+	 */
+	class EnvBuilder {
+		struct Var {
+			std::string_view name;	///< @brief Variable name, refers to the snapshot or to _storage.
+			std::string_view value;	///< @brief Variable value, refers to the snapshot or to _storage.
+			std::string* owned{ nullptr };	///< @brief The string in _storage that holds the value, or nullptr if the value still refers to the snapshot.
+			bool removed{ false };	///< @brief When true, the variable has been unset & is skipped by build().
+		};
+
+		EnvView _base;						///< @brief The snapshot that the builder started from. Keeps file-backed snapshots alive.
+		std::vector<Var> _vars;				///< @brief Every variable, in order. Removed variables are kept so that setting them again keeps their position.
+		std::deque<std::string> _storage;	///< @brief Owns the names & values set through the builder. A deque is used because it never moves existing elements.
+		EnvIndex _index;					///< @brief Hash index of the names of every variable.
+		bool _case_sensitive;				///< @brief When false, names are compared without case sensitivity.
+
+		/**
+		 * @brief Find the position of a variable, including removed ones.
+		 * @param name	- Variable name.
+		 * @returns size_t	- The position in _vars, or EnvIndex::npos.
+		 */
+		size_t find(const std::string_view name) const
+		{
+			return _index.find(name, _case_sensitive, [this](const size_t i) { return _vars[i].name; });
+		}
+
+		std::string& store(std::string&& str)
+		{
+			return _storage.emplace_back(std::move(str));
+		}
+
+		/**
+		 * @brief Set the value of a variable to a string that is moved into storage, adding it if it doesn't exist.
+		 *\n	  A variable that was already set through the builder reuses its string in storage, so repeated edits don't grow the storage.
+		 * @param name	- Variable name.
+		 * @param value	- New value.
+		 * @returns EnvBuilder&
+		 */
+		EnvBuilder& set_owned(const std::string_view name, std::string&& value)
+		{
+			if (const auto pos{ find(name) }; pos != EnvIndex::npos) {
+				auto& var{ _vars[pos] };
+				if (var.owned != nullptr)
+					*var.owned = std::move(value);
+				else
+					var.owned = &store(std::move(value));
+				var.value = *var.owned;
+				var.removed = false;
+			}
+			else {
+				auto& owned{ store(std::move(value)) };
+				_vars.emplace_back(Var{ store(std::string{ name }), owned, &owned });
+				_index.add(_vars.back().name, _vars.size() - 1u);
+			}
+			return *this;
+		}
+
+	public:
+		/**
+		 * @brief Constructor that starts from a snapshot of an environment.
+		 * @param base				- Environment snapshot. The builder keeps a copy of the view, so the underlying envp array must outlive the builder.
+		 * @param case_sensitive	- When false, names are compared without case sensitivity.
+		 */
+		explicit EnvBuilder(EnvView base = {}, const bool case_sensitive = ENV_CASE_SENSITIVE) : _base{ std::move(base) }, _case_sensitive{ case_sensitive }
+		{
+			_vars.reserve(_base.size());
+			for (const auto& [name, value] : _base)
+				_vars.emplace_back(Var{ name, value });
+			_index = EnvIndex{ _vars.begin(), _vars.end(), [](const Var& var) { return var.name; } };
+		}
+		/**
+		 * @brief Constructor that starts from an envp array, such as the one received by main().
+		 * @param envp				- NULL-terminated array of "NAME=VALUE" strings. This must outlive the builder.
+		 * @param case_sensitive	- When false, names are compared without case sensitivity.
+		 */
+		explicit EnvBuilder(char** envp, const bool case_sensitive = ENV_CASE_SENSITIVE) : EnvBuilder(EnvView{ envp }, case_sensitive) {}
+
+		EnvBuilder(const EnvBuilder&) = delete;				///< @brief Not copyable, because the variables refer to this instance's storage.
+		EnvBuilder(EnvBuilder&&) noexcept = default;
+		EnvBuilder& operator=(const EnvBuilder&) = delete;	///< @brief Not copyable, because the variables refer to this instance's storage.
+		EnvBuilder& operator=(EnvBuilder&&) noexcept = default;
+
+		/**
+		 * @brief Retrieve the current value of a variable.
+		 * @param name	- Variable name.
+		 * @returns std::optional<std::string_view>
+		 */
+		[[nodiscard]] std::optional<std::string_view> get(const std::string_view name) const
+		{
+			if (const auto pos{ find(name) }; pos != EnvIndex::npos && !_vars[pos].removed)
+				return _vars[pos].value;
+			return std::nullopt;
+		}
+		/**
+		 * @brief Check if a variable is currently set.
+		 * @param name	- Variable name.
+		 * @returns bool
+		 */
+		[[nodiscard]] bool exists(const std::string_view name) const { return get(name).has_value(); }
+
+		/**
+		 * @brief Set the value of a variable, adding it if it doesn't exist.
+		 * @param name	- Variable name.
+		 * @param value	- New value.
+		 * @returns EnvBuilder&
+		 */
+		EnvBuilder& set(const std::string_view name, const std::string_view value) { return set_owned(name, std::string{ value }); }
+		/**
+		 * @brief Remove a variable. Does nothing if the variable doesn't exist.
+		 * @param name	- Variable name.
+		 * @returns EnvBuilder&
+		 */
+		EnvBuilder& unset(const std::string_view name)
+		{
+			if (const auto pos{ find(name) }; pos != EnvIndex::npos)
+				_vars[pos].removed = true;
+			return *this;
+		}
+		/**
+		 * @brief Add an element to the end of a list variable such as PATH. If the variable doesn't exist or is empty, it is set to the element.
+		 * @param name	- Variable name.
+		 * @param elem	- Element to append.
+		 * @param sep	- Separator between list elements.
+		 * @returns EnvBuilder&
+		 */
+		EnvBuilder& append_list(const std::string_view name, const std::string_view elem, const char sep = ENV_LIST_SEPARATOR)
+		{
+			const auto current{ get(name).value_or(std::string_view{}) };
+			if (current.empty())
+				return set_owned(name, std::string{ elem });
+			std::string value;
+			value.reserve(current.size() + 1u + elem.size());
+			(value += current) += sep;
+			value += elem;
+			return set_owned(name, std::move(value));
+		}
+		/**
+		 * @brief Add an element to the beginning of a list variable such as PATH. If the variable doesn't exist or is empty, it is set to the element.
+		 * @param name	- Variable name.
+		 * @param elem	- Element to prepend.
+		 * @param sep	- Separator between list elements.
+		 * @returns EnvBuilder&
+		 */
+		EnvBuilder& prepend_list(const std::string_view name, const std::string_view elem, const char sep = ENV_LIST_SEPARATOR)
+		{
+			const auto current{ get(name).value_or(std::string_view{}) };
+			if (current.empty())
+				return set_owned(name, std::string{ elem });
+			std::string value;
+			value.reserve(elem.size() + 1u + current.size());
+			(value += elem) += sep;
+			value += current;
+			return set_owned(name, std::move(value));
+		}
+
+		/**
+		 * @brief Retrieve the number of variables that are currently set.
+		 * @returns size_t
+		 */
+		[[nodiscard]] size_t size() const
+		{
+			return static_cast<size_t>(std::count_if(_vars.begin(), _vars.end(), [](const Var& var) { return !var.removed; }));
+		}
+
+		/**
+		 * @brief Retrieve the number of strings owned by the builder. This is at most two per variable, for the name & value of each one that was set through the builder.
+		 * @returns size_t
+		 */
+		[[nodiscard]] size_t owned_strings() const noexcept { return _storage.size(); }
+
+		/**
+		 * @brief Write the environment into a CStringArray as "NAME=VALUE" strings.
+		 *\n	  The block's existing allocation is reused when it is large enough, so reusing one block for every spawn usually doesn't allocate at all.
+		 * @param out	- Block to write to.
+		 * @returns char**	- The NULL-terminated envp array, which is valid for as long as out is alive & unmodified.
+		 */
+		char** build(CStringArray& out) const
+		{
+			out.assign(_vars | std::views::filter([](const Var& var) { return !var.removed; }), [](const Var& var) {
+				return std::array<std::string_view, 3u>{ var.name, "=", var.value };
+			});
+			return out.data();
+		}
+		/**
+		 * @brief Write the environment into a new CStringArray as "NAME=VALUE" strings.
+		 * @returns CStringArray
+		 */
+		[[nodiscard]] CStringArray build() const
+		{
+			CStringArray out;
+			build(out);
+			return out;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,371 @@
+/**
+ * @file EnvView.hpp
+ * @author radj307
+ * @brief Contains the EnvView class, a zero-copy view of the environment that indexes envp or /proc/self/environ without copying any variables.
+ *\n	  Unlike opt::Env & opt::Environment, this does not require the shared library.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <mapped-file.hpp>
+#include <opthash.hpp>
+#include <trace-phases.hpp>
+
+namespace opt {
+#ifdef _WIN32
+	inline constexpr char ENV_LIST_SEPARATOR{ ';' }; ///< @brief Separator used between the elements of list variables such as PATH.
+#else
+	inline constexpr char ENV_LIST_SEPARATOR{ ':' }; ///< @brief Separator used between the elements of list variables such as PATH.
+#endif
+
+	/**
+	 * @brief Compare two strings without case sensitivity. Only ASCII letters are folded, matching fnv1a_folded(). Does not allocate.
+	 * @param l	- Left string.
+	 * @param r	- Right string.
+	 * @returns bool
+	 */
+	constexpr bool iequals(const std::string_view l, const std::string_view r) noexcept
+	{
+		if (l.size() != r.size())
+			return false;
+		const auto fold{ [](const char ch) { return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch; } };
+		for (size_t i{ 0u }; i < l.size(); ++i)
+			if (fold(l[i]) != fold(r[i]))
+				return false;
+		return true;
+	}
+
+	/**
+	 * @class EnvIndex
+	 * @brief Open-addressed hash index of variable names. Each name's case-folded hash is calculated once when the index is built,
+	 *\n	  so both case-sensitive & case-insensitive lookups are O(1) & never allocate.
+	 *\n	  The index only stores positions; the names themselves are retrieved from the owning container through a callback.
+	 */
+	class EnvIndex {
+		struct Slot {
+			uint64_t hash{ 0u };	///< @brief Case-folded hash of the name.
+			uint32_t pos{ 0u };		///< @brief Position of the variable in the owning container, plus one. 0 means the slot is empty.
+		};
+		std::vector<Slot> _slots;	///< @brief Hash table, the size is always 0 or a power of 2.
+		size_t _count{ 0u };		///< @brief Number of indexed names.
+
+		/// @brief Insert a slot into the first empty position of its probe sequence.
+		void insert(const Slot& slot) noexcept
+		{
+			const auto mask{ _slots.size() - 1u };
+			for (auto i{ static_cast<size_t>(slot.hash) & mask }; ; i = (i + 1u) & mask) {
+				if (_slots[i].pos == 0u) {
+					_slots[i] = slot;
+					return;
+				}
+			}
+		}
+		/// @brief Resize the table so that it can hold a given number of names with a load factor <= 0.5, which keeps probe sequences short.
+		void reserve(const size_t count)
+		{
+			size_t capacity{ 8u };
+			while (capacity < count * 2u)
+				capacity <<= 1u;
+			if (capacity <= _slots.size())
+				return;
+			// reinsert in the order the names were added, so that the first match is still the one indexed first.
+			// positions are indexes into the owning container, so each slot is placed at its position instead of sorting them
+			uint32_t last{ 0u };
+			for (const auto& slot : _slots)
+				last = std::max(last, slot.pos);
+			std::vector<Slot> old(last);
+			for (const auto& slot : _slots)
+				if (slot.pos != 0u)
+					old[slot.pos - 1u] = slot;
+			_slots.assign(capacity, Slot{});
+			for (const auto& slot : old)
+				if (slot.pos != 0u)
+					insert(slot);
+		}
+
+	public:
+		static constexpr size_t npos{ static_cast<size_t>(-1) };
+
+		EnvIndex() = default;
+		/**
+		 * @brief Constructor that indexes a range of names.
+		 * @param first	- Iterator to the first element.
+		 * @param last	- Iterator to one past the last element.
+		 * @param name	- Callback that retrieves the name of an element as something convertible to std::string_view.
+		 */
+		template<class Iter, class NameFn>
+		EnvIndex(Iter first, const Iter last, NameFn&& name)
+		{
+			OPT_TRACE_PHASE(trace::phase::INDEX);
+			const auto count{ static_cast<size_t>(std::distance(first, last)) };
+			reserve(count);
+			for (uint32_t pos{ 1u }; first != last; ++first, ++pos)
+				insert({ fnv1a_folded(std::string_view{ name(*first) }), pos });
+			_count = count;
+		}
+
+		/**
+		 * @brief Add a name to the index, growing it when necessary. This is amortized O(1) when positions are dense, such as indexes into a vector.
+		 *\n	  Positions should be added in ascending order, so that the first match is the one that was indexed first.
+		 * @param var_name	- Name to add.
+		 * @param pos		- Position of the name in the owning container.
+		 */
+		void add(const std::string_view var_name, const size_t pos)
+		{
+			reserve(_count + 1u);
+			insert({ fnv1a_folded(var_name), static_cast<uint32_t>(pos + 1u) });
+			++_count;
+		}
+
+		[[nodiscard]] size_t size() const { return _count; } ///< @brief Retrieve the number of indexed names. @returns size_t
+
+		/**
+		 * @brief Find the position of a name. When there are several matches, the one that was indexed first is returned.
+		 * @param var_name			- Name to search for.
+		 * @param case_sensitive	- When false, the name is compared without case sensitivity.
+		 * @param name_at			- Callback that retrieves the name at a given position as something convertible to std::string_view.
+		 * @returns size_t
+		 *\n		npos	- The name wasn't found.
+		 */
+		template<class NameFn>
+		[[nodiscard]] size_t find(const std::string_view var_name, const bool case_sensitive, NameFn&& name_at) const
+		{
+			if (_slots.empty())
+				return npos;
+			const auto hash{ fnv1a_folded(var_name) };
+			const auto mask{ _slots.size() - 1u };
+			for (auto i{ static_cast<size_t>(hash) & mask }; _slots[i].pos != 0u; i = (i + 1u) & mask) {
+				if (_slots[i].hash != hash)
+					continue;
+				const auto pos{ static_cast<size_t>(_slots[i].pos - 1u) };
+				if (const std::string_view name{ name_at(pos) }; case_sensitive ? name == var_name : iequals(name, var_name))
+					return pos;
+			}
+			return npos;
+		}
+	};
+
+	/**
+	 * @class EnvListView
+	 * @brief Splits the value of a list variable (such as PATH) on demand, without allocating. Empty elements are preserved.
+	 */
+	class EnvListView {
+		std::string_view _value;
+		char _sep;
+
+	public:
+		class const_iterator {
+			std::string_view _rest;				///< @brief The unsplit remainder of the list.
+			std::string_view _current;			///< @brief The current element.
+			char _sep{ ENV_LIST_SEPARATOR };	///< @brief Separator between list elements.
+			bool _last{ true };					///< @brief When true, _current is the last element.
+			bool _end{ true };					///< @brief When true, this is the end iterator.
+
+			void next()
+			{
+				const auto pos{ _rest.find(_sep) };
+				_current = _rest.substr(0u, pos);
+				_last = pos == std::string_view::npos;
+				if (!_last)
+					_rest.remove_prefix(pos + 1u);
+			}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = const std::string_view&;
+
+			const_iterator() = default;
+			const_iterator(const std::string_view value, const char sep) : _rest{ value }, _sep{ sep }, _end{ value.empty() } { if (!_end) next(); }
+
+			reference operator*() const { return _current; }
+			pointer operator->() const { return &_current; }
+			const_iterator& operator++()
+			{
+				if (_last)
+					_end = true;
+				else
+					next();
+				return *this;
+			}
+			const_iterator operator++(int) { auto copy{ *this }; ++*this; return copy; }
+			bool operator==(const const_iterator& o) const { return _end == o._end && (_end || _current.data() == o._current.data()); }
+		};
+
+		/**
+		 * @brief Constructor.
+		 * @param value	- The variable's value.
+		 * @param sep	- Separator between list elements.
+		 */
+		constexpr EnvListView(const std::string_view value = {}, const char sep = ENV_LIST_SEPARATOR) : _value{ value }, _sep{ sep } {}
+
+		[[nodiscard]] const_iterator begin() const { return{ _value, _sep }; }		///< @brief Retrieve an iterator to the first element.	@returns const_iterator
+		[[nodiscard]] const_iterator end() const { return{}; }						///< @brief Retrieve the end iterator.					@returns const_iterator
+		[[nodiscard]] bool empty() const { return _value.empty(); }					///< @brief Check if the list has no elements.			@returns bool
+		[[nodiscard]] std::string_view value() const { return _value; }			///< @brief Retrieve the unsplit value.					@returns std::string_view
+		/**
+		 * @brief Retrieve the number of elements in the list.
+		 * @returns size_t
+		 */
+		[[nodiscard]] size_t size() const
+		{
+			return _value.empty() ? 0u : static_cast<size_t>(std::count(_value.begin(), _value.end(), _sep)) + 1u;
+		}
+	};
+
+	/**
+	 * @struct EnvEntry
+	 * @brief A single environment variable. Both views refer to the environment's memory.
+	 */
+	struct EnvEntry {
+		std::string_view name;
+		std::string_view value;
+	};
+
+	/**
+	 * @class EnvView
+	 * @brief Zero-copy view of the environment. Construction records the name & value offsets of each variable in a single pass,
+	 *\n	  values are returned as views, & list variables are only split when they are iterated.
+	 *\n	  When constructed from envp, the envp array must outlive this instance & must not be modified.
+	 */
+	class EnvView {
+		std::shared_ptr<const MappedFile> _file;	///< @brief Owns the environment block when it was read from a file such as /proc/self/environ.
+		std::vector<EnvEntry> _entries;				///< @brief One entry per variable, in the original order.
+		EnvIndex _index;							///< @brief Hash index of the variable names in _entries.
+
+		void reindex()
+		{
+			_index = EnvIndex{ _entries.begin(), _entries.end(), [](const EnvEntry& entry) { return entry.name; } };
+		}
+
+		void push(const std::string_view entry)
+		{
+			if (const auto eqPos{ entry.find('=', 1u) }; eqPos != std::string_view::npos) // start at 1 so that Windows' hidden "=C:=C:\..." variables keep their leading '='
+				_entries.emplace_back(EnvEntry{ entry.substr(0u, eqPos), entry.substr(eqPos + 1u) });
+			else if (!entry.empty())
+				_entries.emplace_back(EnvEntry{ entry, {} });
+		}
+
+	public:
+		/**
+		 * @brief Default Constructor. Creates an empty environment.
+		 */
+		EnvView() = default;
+		/**
+		 * @brief Constructor that indexes an envp array, such as the one received by main().
+		 * @param envp	- NULL-terminated array of "NAME=VALUE" strings.
+		 */
+		explicit EnvView(char** envp)
+		{
+			if (envp == nullptr)
+				return;
+			OPT_TRACE_PHASE(trace::phase::ENVIRONMENT);
+			size_t count{ 0u };
+			while (envp[count] != nullptr)
+				++count;
+			_entries.reserve(count);
+			for (size_t i{ 0u }; i < count; ++i)
+				push(envp[i]);
+			reindex();
+		}
+		/**
+		 * @brief Constructor that indexes a NUL-delimited environment block stored in a file, such as /proc/self/environ or /proc/<pid>/environ.
+		 * @param environ_file	- Path to the environment file.
+		 */
+		explicit EnvView(const std::filesystem::path& environ_file) : _file{ std::make_shared<const MappedFile>(environ_file) }
+		{
+			OPT_TRACE_PHASE(trace::phase::ENVIRONMENT);
+			auto block{ _file->view() };
+			_entries.reserve(static_cast<size_t>(std::count(block.begin(), block.end(), '\0')) + 1u);
+			while (!block.empty()) {
+				const auto pos{ block.find('\0') };
+				push(block.substr(0u, pos));
+				if (pos == std::string_view::npos)
+					break;
+				block.remove_prefix(pos + 1u);
+			}
+			reindex();
+		}
+
+	#ifdef __linux__
+		/**
+		 * @brief Create a view of this process's environment from /proc/self/environ.
+		 *\n	  Note that this reflects the environment the process was started with, & does not include later calls to setenv().
+		 * @returns EnvView
+		 */
+		static EnvView from_proc() { return EnvView{ std::filesystem::path{ "/proc/self/environ" } }; }
+	#endif
+
+		[[nodiscard]] auto begin() const { return _entries.begin(); }	///< @brief Retrieve an iterator to the first variable.				@returns std::vector<EnvEntry>::const_iterator
+		[[nodiscard]] auto end() const { return _entries.end(); }		///< @brief Retrieve an iterator to one past the last variable.	@returns std::vector<EnvEntry>::const_iterator
+		[[nodiscard]] size_t size() const { return _entries.size(); }	///< @brief Retrieve the number of variables.						@returns size_t
+		[[nodiscard]] bool empty() const { return _entries.empty(); }	///< @brief Check if there are no variables.						@returns bool
+
+		/**
+		 * @brief Retrieve an iterator to a variable.
+		 * @param var_name			- Variable name to search for.
+		 * @param case_sensitive	- When false, the name is compared without case sensitivity.
+		 * @returns std::vector<EnvEntry>::const_iterator
+		 */
+		[[nodiscard]] std::vector<EnvEntry>::const_iterator find(const std::string_view var_name, const bool case_sensitive = false) const
+		{
+			if (const auto pos{ _index.find(var_name, case_sensitive, [this](const size_t i) { return _entries[i].name; }) }; pos != EnvIndex::npos)
+				return _entries.begin() + static_cast<ptrdiff_t>(pos);
+			return _entries.end();
+		}
+
+		/**
+		 * @brief Check if a variable exists.
+		 * @param var_name			- Variable name to search for.
+		 * @param case_sensitive	- When false, the name is compared without case sensitivity.
+		 * @returns bool
+		 */
+		[[nodiscard]] bool exists(const std::string_view var_name, const bool case_sensitive = false) const
+		{
+			return find(var_name, case_sensitive) != _entries.end();
+		}
+
+		/**
+		 * @brief Retrieve the value of a variable.
+		 * @param var_name			- Variable name to search for.
+		 * @param case_sensitive	- When false, the name is compared without case sensitivity.
+		 * @returns std::optional<std::string_view>
+		 */
+		[[nodiscard]] std::optional<std::string_view> get(const std::string_view var_name, const bool case_sensitive = false) const
+		{
+			if (const auto it{ find(var_name, case_sensitive) }; it != _entries.end())
+				return it->value;
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief Retrieve the value of a list variable, which is split when it is iterated.
+		 * @param var_name			- Variable name to search for.
+		 * @param sep				- Separator between list elements.
+		 * @param case_sensitive	- When false, the name is compared without case sensitivity.
+		 * @returns EnvListView		- This is empty if the variable doesn't exist.
+		 */
+		[[nodiscard]] EnvListView list(const std::string_view var_name, const char sep = ENV_LIST_SEPARATOR, const bool case_sensitive = false) const
+		{
+			return{ get(var_name, case_sensitive).value_or(std::string_view{}), sep };
+		}
+
+		/**
+		 * @brief Retrieve the elements of the PATH variable.
+		 * @returns EnvListView
+		 */
+		[[nodiscard]] EnvListView PATH() const { return list("PATH"); }
+		/**
+		 * @brief Retrieve the value of the HOME variable.
+		 * @returns std::optional<std::string_view>
+		 */
+		[[nodiscard]] std::optional<std::string_view> HOME() const { return get("HOME"); }
+	};
+}
\ No newline at end of file
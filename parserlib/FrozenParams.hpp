@@ -0,0 +1,384 @@
+/**
+ * @file FrozenParams.hpp
+ * @author radj307
+ * @brief Contains the FrozenParams class, a read-only, pointer-free snapshot of parsed arguments that can be placed in shared memory.
+ *\n_USAGE:_
+ *\n	Call opt::freeze() on a ParamsAPI instance to get a snapshot buffer, then construct a FrozenParams view over the buffer.
+ *\n	Because the snapshot only contains offsets, it can be written to a memfd or any other shared mapping & attached by other
+ *\n	processes (such as pre-forked workers) without copying or touching any reference counts or allocator metadata.
+ */
+#pragma once
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <ParamsAPI.hpp>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace opt {
+	inline constexpr std::string_view FROZEN_MAGIC{ "OPTFRZ01" }; ///< @brief Identifies a frozen snapshot, & its format version.
+
+	/**
+	 * @struct FrozenHeader
+	 * @brief Fixed-size header at the start of every frozen snapshot.
+	 */
+	struct FrozenHeader {
+		char magic[8];			///< @brief Always equal to FROZEN_MAGIC.
+		uint32_t count;			///< @brief Number of FrozenRecords following the header.
+		uint32_t pool_size;		///< @brief Size of the string pool following the records.
+		uint32_t has_arg0;		///< @brief Non-zero if arg0 is present.
+		uint32_t arg0_off;		///< @brief Offset of arg0 in the string pool.
+		uint32_t arg0_len;		///< @brief Length of arg0.
+		uint32_t reserved;		///< @brief Padding, always 0.
+	};
+	/**
+	 * @struct FrozenRecord
+	 * @brief Describes one argument in a frozen snapshot. Offsets are relative to the start of the string pool.
+	 */
+	struct FrozenRecord {
+		uint8_t type;			///< @brief The argument's Type.
+		uint8_t has_capture;	///< @brief Non-zero if the argument has a captured value.
+		uint16_t reserved;		///< @brief Padding, always 0.
+		uint32_t name_off;		///< @brief Offset of the argument's name.
+		uint32_t name_len;		///< @brief Length of the argument's name.
+		uint32_t cap_off;		///< @brief Offset of the captured value.
+		uint32_t cap_len;		///< @brief Length of the captured value.
+	};
+
+	/**
+	 * @brief Create a frozen snapshot of a range of arguments.
+	 * @param first	- Iterator to the first argument.
+	 * @param last	- Iterator to one past the last argument.
+	 * @param arg0	- Optional argv[0].
+	 * @returns std::string
+	 * @throws std::length_error	- If the snapshot would exceed 4 GiB.
+	 */
+	inline std::string freeze(ContainerType::const_iterator first, const ContainerType::const_iterator& last, const std::optional<std::string>& arg0 = std::nullopt)
+	{
+		const auto count{ static_cast<size_t>(last - first) };
+		size_t pool_size{ arg0.has_value() ? arg0->size() : 0u };
+		for (auto it{ first }; it != last; ++it)
+			pool_size += it->name_view().size() + (it->hasv() ? it->capture()->size() : 0u);
+		if (count > UINT32_MAX || pool_size > UINT32_MAX)
+			throw std::length_error("Argument container is too large to freeze!");
+
+		std::string buffer(sizeof(FrozenHeader) + count * sizeof(FrozenRecord) + pool_size, '\0');
+		char* const records{ buffer.data() + sizeof(FrozenHeader) };
+		char* const pool{ records + count * sizeof(FrozenRecord) };
+		uint32_t pos{ 0u };
+		const auto push{ [&pool, &pos](const std::string_view str) {
+			const auto off{ pos };
+			std::memcpy(pool + pos, str.data(), str.size());
+			pos += static_cast<uint32_t>(str.size());
+			return off;
+		} };
+
+		FrozenHeader header{};
+		std::memcpy(header.magic, FROZEN_MAGIC.data(), sizeof(header.magic));
+		header.count = static_cast<uint32_t>(count);
+		header.pool_size = static_cast<uint32_t>(pool_size);
+		if (arg0.has_value()) {
+			header.has_arg0 = 1u;
+			header.arg0_len = static_cast<uint32_t>(arg0->size());
+			header.arg0_off = push(arg0.value());
+		}
+		std::memcpy(buffer.data(), &header, sizeof(FrozenHeader));
+
+		for (size_t i{ 0u }; first != last; ++first, ++i) {
+			FrozenRecord rec{};
+			rec.type = static_cast<uint8_t>(first->type());
+			const auto name{ first->name_view() };
+			rec.name_len = static_cast<uint32_t>(name.size());
+			rec.name_off = push(name);
+			if (const auto& cap{ first->capture() }; cap.has_value()) {
+				rec.has_capture = 1u;
+				rec.cap_len = static_cast<uint32_t>(cap->size());
+				rec.cap_off = push(cap.value());
+			}
+			std::memcpy(records + i * sizeof(FrozenRecord), &rec, sizeof(FrozenRecord));
+		}
+		return buffer;
+	}
+	/**
+	 * @brief Create a frozen snapshot of a ParamsAPI instance.
+	 * @param args	- ParamsAPI instance.
+	 * @returns std::string
+	 */
+	inline std::string freeze(const ParamsAPI& args)
+	{
+		return freeze(args.begin(), args.end(), args.arg0());
+	}
+
+	/**
+	 * @struct FrozenArgument
+	 * @brief A single argument from a FrozenParams view. All strings refer to the snapshot's memory.
+	 */
+	struct FrozenArgument {
+		Type type;
+		std::string_view name;
+		std::optional<std::string_view> capture;
+
+		bool hasv() const { return capture.has_value(); }
+		bool operator==(const Type& o) const { return type == o; }
+
+		/**
+		 * @brief Convert this argument back into an owning VariantArgument.
+		 * @returns VariantArgument
+		 */
+		VariantArgument thaw() const
+		{
+			const auto cap{ capture.has_value() ? std::optional<std::string>{ capture.value() } : std::nullopt };
+			switch (type) {
+			case Type::OPTION:
+				return{ std::make_pair(std::string{ name }, cap) };
+			case Type::FLAG:
+				return{ std::make_pair(name.front(), cap) };
+			default:
+				return{ std::string{ name } };
+			}
+		}
+	};
+
+	/**
+	 * @class FrozenParams
+	 * @brief Read-only view over a snapshot produced by opt::freeze(). Provides the same queries as ParamsAPI, using indexes in place of iterators.
+	 *\n	  This class does not own the snapshot; the underlying memory must outlive it.
+	 */
+	class FrozenParams {
+		std::string_view _data;		///< @brief The snapshot memory.
+		FrozenHeader _header{};		///< @brief Copy of the snapshot's header.
+		const char* _records{ nullptr };
+		const char* _pool{ nullptr };
+
+		FrozenRecord record(const size_t i) const
+		{
+			FrozenRecord rec;
+			std::memcpy(&rec, _records + i * sizeof(FrozenRecord), sizeof(FrozenRecord));
+			return rec;
+		}
+
+	public:
+		static constexpr size_t npos{ static_cast<size_t>(-1) };
+
+		class const_iterator {
+			const FrozenParams* _inst{ nullptr };
+			size_t _pos{ 0u };
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = FrozenArgument;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = FrozenArgument;
+
+			const_iterator() = default;
+			const_iterator(const FrozenParams* inst, const size_t pos) : _inst{ inst }, _pos{ pos } {}
+
+			FrozenArgument operator*() const { return _inst->at(_pos); }
+			const_iterator& operator++() { ++_pos; return *this; }
+			const_iterator operator++(int) { auto copy{ *this }; ++_pos; return copy; }
+			difference_type operator-(const const_iterator& o) const { return static_cast<difference_type>(_pos) - static_cast<difference_type>(o._pos); }
+			bool operator==(const const_iterator& o) const { return _pos == o._pos; }
+			size_t index() const { return _pos; }
+		};
+
+		/**
+		 * @brief Constructor that attaches to a snapshot.
+		 * @param snapshot	- Memory containing a snapshot produced by opt::freeze().
+		 * @throws std::runtime_error	- If the snapshot is malformed.
+		 */
+		explicit FrozenParams(const std::string_view snapshot) : _data{ snapshot }
+		{
+			if (_data.size() < sizeof(FrozenHeader))
+				throw std::runtime_error("Invalid frozen ParamsAPI snapshot!");
+			std::memcpy(&_header, _data.data(), sizeof(FrozenHeader));
+			if (std::string_view{ _header.magic, sizeof(_header.magic) } != FROZEN_MAGIC
+				|| _data.size() < sizeof(FrozenHeader) + static_cast<size_t>(_header.count) * sizeof(FrozenRecord) + _header.pool_size)
+				throw std::runtime_error("Invalid frozen ParamsAPI snapshot!");
+			_records = _data.data() + sizeof(FrozenHeader);
+			_pool = _records + static_cast<size_t>(_header.count) * sizeof(FrozenRecord);
+			for (size_t i{ 0u }; i < _header.count; ++i) // validate once here so that queries never need bounds checks
+				if (const auto rec{ record(i) }; static_cast<uint64_t>(rec.name_off) + rec.name_len > _header.pool_size || static_cast<uint64_t>(rec.cap_off) + rec.cap_len > _header.pool_size
+					|| rec.type < static_cast<uint8_t>(Type::PARAMETER) || rec.type > static_cast<uint8_t>(Type::FLAG) || (rec.type == static_cast<uint8_t>(Type::FLAG) && rec.name_len != 1u))
+					throw std::runtime_error("Invalid frozen ParamsAPI snapshot!");
+			if (_header.has_arg0 && static_cast<uint64_t>(_header.arg0_off) + _header.arg0_len > _header.pool_size)
+				throw std::runtime_error("Invalid frozen ParamsAPI snapshot!");
+		}
+
+		[[nodiscard]] size_t size() const { return _header.count; }					///< @brief Retrieve the number of arguments.		@returns size_t
+		[[nodiscard]] bool empty() const { return _header.count == 0u; }			///< @brief Check if there are no arguments.		@returns bool
+		[[nodiscard]] const_iterator begin() const { return{ this, 0u }; }			///< @brief Retrieve an iterator to the first argument.	@returns const_iterator
+		[[nodiscard]] const_iterator end() const { return{ this, _header.count }; }	///< @brief Retrieve an iterator to one past the last argument.	@returns const_iterator
+
+		/**
+		 * @brief Retrieve the argument at a given index.
+		 * @param pos	- Index of the argument.
+		 * @returns FrozenArgument
+		 * @throws std::out_of_range	- If pos is out of range.
+		 */
+		[[nodiscard]] FrozenArgument at(const size_t pos) const
+		{
+			if (pos >= _header.count)
+				throw std::out_of_range("FrozenParams index out of range!");
+			const auto rec{ record(pos) };
+			return{
+				static_cast<Type>(rec.type),
+				{ _pool + rec.name_off, rec.name_len },
+				rec.has_capture ? std::optional<std::string_view>{ std::string_view{ _pool + rec.cap_off, rec.cap_len } } : std::nullopt
+			};
+		}
+
+		/**
+		 * @brief Retrieve the value of argv[0], if it was present when the snapshot was created.
+		 * @returns std::optional<std::string_view>
+		 */
+		[[nodiscard]] std::optional<std::string_view> arg0() const
+		{
+			if (_header.has_arg0)
+				return std::string_view{ _pool + _header.arg0_off, _header.arg0_len };
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief Retrieve the index of an argument with a given name, & optionally a given type.
+		 * @param arg	- Argument name to search for.
+		 * @param off	- Index to begin searching at.
+		 * @param type	- When not MONOSTATE, only arguments of this type are matched.
+		 * @returns size_t
+		 *\n		npos	- No matching argument was found.
+		 */
+		[[nodiscard]] size_t find(const std::string_view arg, const size_t off = 0u, const Type type = Type::MONOSTATE) const
+		{
+			for (size_t i{ off }; i < _header.count; ++i)
+				if (const auto rec{ record(i) }; (type == Type::MONOSTATE || rec.type == static_cast<uint8_t>(type)) && rec.name_len == arg.size() && std::memcmp(_pool + rec.name_off, arg.data(), arg.size()) == 0)
+					return i;
+			return npos;
+		}
+		/**
+		 * @brief Retrieve the index of an argument with a given name & type.
+		 * @tparam SearchTy	- Parameter / Option / Flag
+		 * @param arg		- Argument name to search for.
+		 * @param off		- Index to begin searching at.
+		 * @returns size_t
+		 */
+		template<ValidArgumentType SearchTy>
+		[[nodiscard]] size_t find(const auto& arg, const size_t off = 0u) const
+		{
+			return find(to_view(arg), off, determineVariantType<SearchTy>());
+		}
+
+		/**
+		 * @brief Check if an argument with any type was included on the commandline.
+		 * @param arg	- Argument name to search for.
+		 * @returns bool
+		 */
+		[[nodiscard]] bool check(const auto& arg) const { return find(to_view(arg)) != npos; }
+		/**
+		 * @brief Check if an argument with a specified type was included on the commandline.
+		 * @tparam SearchTy	- Parameter / Option / Flag
+		 * @param arg		- Argument name to search for.
+		 * @returns bool
+		 */
+		template<ValidArgumentType SearchTy> [[nodiscard]] bool check(const auto& arg) const { return find<SearchTy>(arg) != npos; }
+		[[nodiscard]] bool check_opt(const std::string_view arg) const { return check<Option>(arg); }		///< @brief Check if a specified Option was included on the commandline.	@returns bool
+		[[nodiscard]] bool check_param(const std::string_view arg) const { return check<Parameter>(arg); }	///< @brief Check if a specified Parameter was included on the commandline.	@returns bool
+		[[nodiscard]] bool check_flag(const char arg) const { return check<Flag>(arg); }					///< @brief Check if a specified Flag was included on the commandline.		@returns bool
+
+		/**
+		 * @brief Get the captured value of an argument. The returned view refers to the snapshot's memory.
+		 * @param arg	- Argument name to search for.
+		 * @param off	- Index to begin searching at.
+		 * @returns std::optional<std::string_view>
+		 */
+		[[nodiscard]] std::optional<std::string_view> getv(const auto& arg, const size_t off = 0u) const
+		{
+			if (const auto pos{ find(to_view(arg), off) }; pos != npos)
+				return at(pos).capture;
+			return std::nullopt;
+		}
+		/**
+		 * @brief Get the captured value of an argument with a specific type. The returned view refers to the snapshot's memory.
+		 * @tparam SearchTy	- Option / Flag
+		 * @param arg		- Argument name to search for.
+		 * @param off		- Index to begin searching at.
+		 * @returns std::optional<std::string_view>
+		 */
+		template<class SearchTy> requires std::is_same_v<SearchTy, Option> || std::is_same_v<SearchTy, Flag>
+		[[nodiscard]] std::optional<std::string_view> getv(const auto& arg, const size_t off = 0u) const
+		{
+			if (const auto pos{ find<SearchTy>(arg, off) }; pos != npos)
+				return at(pos).capture;
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief Convert this snapshot back into an owning ParamsAPI instance.
+		 * @returns ParamsAPI
+		 */
+		[[nodiscard]] ParamsAPI thaw() const
+		{
+			ContainerType cont;
+			cont.reserve(size());
+			for (const auto& it : *this)
+				cont.emplace_back(it.thaw());
+			const auto a0{ arg0() };
+			return ParamsAPI{ std::move(cont), a0.has_value() ? std::optional<std::string>{ a0.value() } : std::nullopt };
+		}
+	};
+
+#ifdef __linux__
+	/**
+	 * @brief Write a frozen snapshot into an empty memfd, then seal it against writes & resizing. This is used by freeze_to_memfd().
+	 * @param fd		- An empty memfd, which must have been created with MFD_ALLOW_SEALING. It is closed if this fails.
+	 * @param snapshot	- Snapshot produced by opt::freeze().
+	 * @returns int
+	 *\n		-1	- The memfd could not be written or sealed, check errno for details.
+	 *\n		*	- fd.
+	 */
+	inline int seal_snapshot(const int fd, const std::string_view snapshot)
+	{
+		for (size_t written{ 0u }; written < snapshot.size(); ) {
+			const auto rc{ ::write(fd, snapshot.data() + written, snapshot.size() - written) };
+			if (rc <= 0) {
+				::close(fd);
+				return -1;
+			}
+			written += static_cast<size_t>(rc);
+		}
+		if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1) {
+			::close(fd);
+			return -1;
+		}
+		return fd;
+	}
+	/**
+	 * @brief Write a frozen snapshot into a new sealed memfd, which can be inherited by child processes & attached with MappedFile(fd) + FrozenParams.
+	 *\n	  The memfd is sealed against writes & resizing, so every attached process is guaranteed to see the same contents.
+	 * @param snapshot	- Snapshot produced by opt::freeze().
+	 * @param name		- Name of the memfd, this is only used for debugging.
+	 * @returns int
+	 *\n		-1	- The memfd could not be created, written or sealed, check errno for details.
+	 *\n		*	- The file descriptor. The caller is responsible for closing it.
+	 */
+	inline int freeze_to_memfd(const std::string_view snapshot, const char* name = "opt-frozen-params")
+	{
+		const int fd{ memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING) };
+		if (fd == -1)
+			return -1;
+		return seal_snapshot(fd, snapshot);
+	}
+	/**
+	 * @brief Write a frozen snapshot of a ParamsAPI instance into a new sealed memfd.
+	 * @param args	- ParamsAPI instance.
+	 * @param name	- Name of the memfd, this is only used for debugging.
+	 * @returns int
+	 */
+	inline int freeze_to_memfd(const ParamsAPI& args, const char* name = "opt-frozen-params")
+	{
+		return freeze_to_memfd(freeze(args), name);
+	}
+#endif
+}
\ No newline at end of file
@@ -8,6 +8,12 @@
 #include <vectorize.hpp>
 #include <var.hpp>
 #include <parseArgs.hpp>
+#include <ParamsView.hpp>
+#include <render-argv.hpp>
+#include <canonicalize-args.hpp>
+#include <diffArgs.hpp>
+#include <instrument-allocations.hpp>
+#include <ArgIndex.hpp>
 
 namespace opt {
 	// Concept that only allows std::string/char* or char
@@ -31,7 +37,9 @@ namespace opt {
 
 	private:
 		std::optional<std::string> _arg0; ///< @brief Contains argv[0], if it could be found during initialization.
+		ArgsFingerprint _fingerprint; ///< @brief Fingerprint of _args, calculated by parseArgs while parsing. This is declared before _args so that it is constructed first.
 		ContainerType _args; ///< @brief Internal container for holding arguments as VariantArgument types.
+		AdaptiveIndex _index; ///< @brief Counts queries, & replaces linear searches with a hashed index once they become frequent.
 
 	public:
 		/**
@@ -43,8 +51,9 @@ namespace opt {
 		 * @param argc			- Argument Array Size
 		 * @param argv			- Argument Array
 		 * @param parser_cfg	- Parser Config Instance, if std::nullopt is received, uses the default ParserConfig instance.
+		 * @param stats			- Optional pointer to a ParseStats instance that receives a summary of the parsed arguments.
 		 */
-		explicit ParamsAPI(const int argc, char** argv, std::optional<ParserConfig> parser_cfg = std::nullopt) : _arg0{ argv[0] }, _args{ parseArgs(vectorize(argc, argv), parser_cfg.value_or(ParserConfig{})) } {}
+		explicit ParamsAPI(const int argc, char** argv, std::optional<ParserConfig> parser_cfg = std::nullopt, ParseStats* stats = nullptr) : _arg0{ argv[0] }, _args{ OPT_INSTRUMENT_EXPR(PARAMS_API, parseArgs(vectorize(argc, argv), parser_cfg.value_or(ParserConfig{}), stats, &_fingerprint)) } {}
 
 		/**
 		 * @brief Variadic Constructor that accepts flag/option names that capture additional arguments.
@@ -56,10 +65,10 @@ namespace opt {
 		template<ValidInputType... VT> requires (sizeof...(VT) > 0)
 		explicit ParamsAPI(const int argc, char** argv, VT... captures) :
 			_arg0{ argv[0] },
-			_args{ parseArgs(vectorize(argc, argv),
+			_args{ OPT_INSTRUMENT_EXPR(PARAMS_API, parseArgs(vectorize(argc, argv),
 				ParserConfig{
 						var::variadic_accumulate<std::string>(to_string(captures)...)
-				})
+				}, nullptr, &_fingerprint))
 			}
 		{}
 
@@ -68,14 +77,15 @@ namespace opt {
 		 * @param args			- Argument Vector
 		 * @param parser_cfg	- Parser Config Instance, if std::nullopt is received, uses the default ParserConfig instance.
 		 * @param arg0			- Optional Argument 0.
+		 * @param stats			- Optional pointer to a ParseStats instance that receives a summary of the parsed arguments.
 		 */
-		explicit ParamsAPI(std::vector<std::string>&& args, std::optional<ParserConfig> parser_cfg = std::nullopt, std::optional<std::string> arg0 = std::nullopt) : _arg0{ std::move(arg0) }, _args{ parseArgs(args, parser_cfg.value_or(ParserConfig{})) } {}
+		explicit ParamsAPI(std::vector<std::string>&& args, std::optional<ParserConfig> parser_cfg = std::nullopt, std::optional<std::string> arg0 = std::nullopt, ParseStats* stats = nullptr) : _arg0{ std::move(arg0) }, _args{ OPT_INSTRUMENT_EXPR(PARAMS_API, parseArgs(args, parser_cfg.value_or(ParserConfig{}), stats, &_fingerprint)) } {}
 		/**
 		 * @brief Container-Move Constructor.
 		 * @param arg_container	- Container of arguments to move into this instance.
 		 * @param arg0			- Optional argument 0 override.
 		 */
-		explicit ParamsAPI(ContainerType&& arg_container, std::optional<std::string> arg0 = std::nullopt) : _arg0{ std::move(arg0) }, _args{ std::move(arg_container) } {}
+		explicit ParamsAPI(ContainerType&& arg_container, std::optional<std::string> arg0 = std::nullopt) : _arg0{ std::move(arg0) }, _fingerprint{ arg_container.begin(), arg_container.end() }, _args{ std::move(arg_container) } {}
 
 		[[nodiscard]] auto begin() const { return _args.begin(); }					///< @brief Forward ContainerType::begin()	@returns ContainerType::const_iterator
 		[[nodiscard]] auto end() const { return _args.end(); }						///< @brief Forward ContainerType::end()	@returns ContainerType::const_iterator
@@ -145,6 +155,8 @@ namespace opt {
 		[[nodiscard]] std::optional<std::string> getv(const T& arg, ContainerType::const_iterator off) const
 		{
 			static_assert( ValidInputType<T>, "Invalid input type! Must be std::string, char*, or char!" );
+			OPT_INSTRUMENT_SCOPE(GETV);
+			_index.record_getv();
 			if ( const auto pos{ find(to_string(arg), off) }; pos != _args.end() && pos->hasv() )
 				return pos->getv();
 			return std::nullopt;
@@ -169,6 +181,8 @@ namespace opt {
 		template<class SearchTy, ValidInputType T> requires std::is_same_v<SearchTy, Option> || std::is_same_v<SearchTy, Flag>
 		[[nodiscard]] std::optional<std::string> getv(const T& arg, ContainerType::const_iterator off) const
 		{
+			OPT_INSTRUMENT_SCOPE(GETV);
+			_index.record_getv();
 			if ( const auto pos{ find<SearchTy>(to_string(arg), off) }; pos != _args.end() && pos->hasv() )
 				return pos->getv();
 			return std::nullopt;
@@ -201,9 +215,12 @@ namespace opt {
 		template<ValidInputType T>
 		[[nodiscard]] auto find(const T& arg, ContainerType::const_iterator off) const
 		{
+			OPT_INSTRUMENT_SCOPE(FIND);
 			const auto argstr{ to_string(arg) };
+			if (const auto* index{ _index.acquire(_args) }; index != nullptr)
+				return _args.begin() + static_cast<ptrdiff_t>(index->find(_args, argstr, std::nullopt, static_cast<size_t>(off - _args.begin())));
 			return std::find_if(off, _args.end(), [&argstr](const VariantArgument& elem) {
-				return elem.name() == argstr;
+				return elem.name_view() == argstr;
 				});
 		}
 		/**
@@ -225,10 +242,13 @@ namespace opt {
 		 */
 		template<ValidArgumentType SearchTy, ValidInputType T> [[nodiscard]] auto find(const T& arg, ContainerType::const_iterator off) const
 		{
+			OPT_INSTRUMENT_SCOPE(FIND);
 			Type target_type{ determineVariantType<SearchTy>() };
 			const auto argstr{ to_string(arg) };
+			if (const auto* index{ _index.acquire(_args) }; index != nullptr)
+				return _args.begin() + static_cast<ptrdiff_t>(index->find(_args, argstr, target_type, static_cast<size_t>(off - _args.begin())));
 			return std::find_if(off, _args.end(), [&target_type, &argstr](const VariantArgument& elem) {
-				return elem.type() == target_type && elem.name() == argstr;
+				return elem.type() == target_type && elem.name_view() == argstr;
 				});
 		}
 		/**
@@ -242,9 +262,79 @@ namespace opt {
 			return find<SearchTy>(std::forward<decltype(arg)>(arg), _args.begin());
 		}
 
+		/**
+		 * @brief Set when lookups switch from a linear search to a hashed index. This should be called before making queries from several threads.
+		 * @param threshold	- Number of lookups after which the index is built. 0 builds it on the first lookup, & AdaptiveIndex::NEVER disables it.
+		 * @param min_size	- Minimum number of arguments required to build the index. Smaller commandlines always use a linear search.
+		 */
+		void configure_index(const size_t threshold, const size_t min_size = AdaptiveIndex::DEFAULT_MIN_SIZE) { _index.configure(threshold, min_size); }
+		/**
+		 * @brief Retrieve the number of queries served by this instance, & whether they were served by the index.
+		 * @returns QueryProfile
+		 */
+		[[nodiscard]] QueryProfile query_profile() const { return _index.profile(); }
+
 		// Return a copy of the container
 		[[nodiscard]] ContainerType getAll() const { return _args; }
 
+		/**
+		 * @brief Retrieve a non-owning view of the container. Queries made through the view never allocate.
+		 * @returns ParamsView
+		 */
+		[[nodiscard]] ParamsView view() const { return{ _args, _arg0.has_value() ? std::optional<std::string_view>{ _arg0.value() } : std::nullopt }; }
+
+		/**
+		 * @brief Retrieve a stable 64-bit fingerprint of the arguments, which was calculated during initialization. Equal arguments always have the same fingerprint.
+		 * @param order_insensitive	- When true, the order of flags & options is ignored. Parameters must still be in the same order.
+		 * @returns uint64_t
+		 */
+		[[nodiscard]] uint64_t fingerprint(const bool order_insensitive = false) const noexcept { return _fingerprint.value(order_insensitive); }
+
+		/**
+		 * @brief Retrieve a copy of this instance with the arguments in canonical form. See canonical_order().
+		 * @returns ParamsAPI
+		 */
+		[[nodiscard]] ParamsAPI canonicalize() const { return ParamsAPI{ opt::canonicalize(_args), _arg0 }; }
+		/**
+		 * @brief Retrieve the fingerprint of the arguments in canonical form. Instances that compare equal always have the same canonical fingerprint.
+		 * @returns uint64_t
+		 */
+		[[nodiscard]] uint64_t canonical_fingerprint() const { return opt::canonical_fingerprint(_args.begin(), _args.end()); }
+		/**
+		 * @brief Check if this instance's arguments have the same meaning as another instance's arguments, by comparing their canonical forms. argv[0] is not compared.
+		 *\n	  Repeated options & flags are compared by their first occurrence, which is the one returned by find() & getv(). See canonical_order().
+		 * @param o	- Other instance.
+		 * @returns bool
+		 */
+		[[nodiscard]] bool operator==(const ParamsAPI& o) const { return canonical_equal(_args, o._args); }
+		/**
+		 * @brief Calculate the differences between this instance's arguments & another instance's arguments. See diffArgs().
+		 * @param o	- Other (new) instance.
+		 * @returns std::vector<ArgEdit>
+		 */
+		[[nodiscard]] std::vector<ArgEdit> diff(const ParamsAPI& o) const { return diffArgs(view(), o.view()); }
+
+		/**
+		 * @brief Render a subset of the arguments back into an argv array, in a single allocation. See render_argv().
+		 * @param out			- Block to write to. Its existing allocation is reused when it is large enough.
+		 * @param filter		- Predicate that accepts a const VariantArgument& & returns true for each argument that should be rendered.
+		 * @param include_arg0	- When true, argv[0] is written as the first argument if it is known.
+		 * @returns char**		- The NULL-terminated argv array, which is valid for as long as out is alive & unmodified.
+		 */
+		template<class Pred> requires std::predicate<Pred&, const VariantArgument&>
+		char** to_argv(CStringArray& out, Pred&& filter, const bool include_arg0 = true) const
+		{
+			const auto v{ view() };
+			return render_argv(out, v, std::forward<Pred>(filter), include_arg0 ? v.arg0() : std::nullopt);
+		}
+		/**
+		 * @brief Render every argument back into an argv array, in a single allocation. See render_argv().
+		 * @param out			- Block to write to. Its existing allocation is reused when it is large enough.
+		 * @param include_arg0	- When true, argv[0] is written as the first argument if it is known.
+		 * @returns char**		- The NULL-terminated argv array, which is valid for as long as out is alive & unmodified.
+		 */
+		char** to_argv(CStringArray& out, const bool include_arg0 = true) const { return to_argv(out, [](const VariantArgument&) { return true; }, include_arg0); }
+
 		template<ValidArgumentType SearchTy, class RT> requires std::is_same_v<RT, IteratorContainerT>
 		[[nodiscard]] RT getWithType(ContainerType::const_iterator first, ContainerType::const_iterator last) const
 		{
@@ -372,6 +462,8 @@ namespace opt {
 		template<ValidInputType T>
 		[[nodiscard]] bool check(const T& arg) const
 		{
+			OPT_INSTRUMENT_SCOPE(CHECK);
+			_index.record_check();
 			return find(to_string(arg)) != _args.end();
 		}
 		/**
@@ -382,6 +474,8 @@ namespace opt {
 		 */
 		template<ValidArgumentType SearchTy, ValidInputType T> [[nodiscard]] bool check(const T& arg) const
 		{
+			OPT_INSTRUMENT_SCOPE(CHECK);
+			_index.record_check();
 			return find<SearchTy>(to_string(arg)) != _args.end();
 		}
 		/**
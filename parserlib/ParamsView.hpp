@@ -0,0 +1,126 @@
+/**
+ * @file ParamsView.hpp
+ * @author radj307
+ * @brief Contains the ParamsView class, a non-owning view of a range of parsed arguments with the same queries as ParamsAPI.
+ */
+#pragma once
+#include <concepts>
+#include <string_view>
+#include <parseArgs.hpp>
+
+namespace opt {
+	/** @brief Resolve a char -> std::string_view referring to that char. */
+	template<class T> requires std::same_as<T, char> constexpr std::string_view to_view(const T& ch) { return{ &ch, 1u }; }
+	/** @brief Resolve any other string-like type -> std::string_view. */
+	constexpr std::string_view to_view(const std::string_view str) { return str; }
+
+	/**
+	 * @class ParamsView
+	 * @brief Non-owning view of a range of arguments in a ContainerType. Queries never allocate, & captured values are returned as views.
+	 *\n	  The view is only valid for as long as the underlying container is alive & unmodified.
+	 */
+	class ParamsView {
+		ContainerType::const_iterator _first;			///< @brief Iterator to the first argument in the view.
+		ContainerType::const_iterator _last;			///< @brief Iterator to one past the last argument in the view.
+		std::optional<std::string_view> _arg0;			///< @brief Contains argv[0], if it is known.
+
+	public:
+		/**
+		 * @brief Constructor that views a range of arguments.
+		 * @param first	- Iterator to the first argument.
+		 * @param last	- Iterator to one past the last argument.
+		 * @param arg0	- Optional argument 0.
+		 */
+		ParamsView(ContainerType::const_iterator first, ContainerType::const_iterator last, std::optional<std::string_view> arg0 = std::nullopt) : _first{ std::move(first) }, _last{ std::move(last) }, _arg0{ std::move(arg0) } {}
+		/**
+		 * @brief Constructor that views an entire container.
+		 * @param cont	- Argument container.
+		 * @param arg0	- Optional argument 0.
+		 */
+		ParamsView(const ContainerType& cont, std::optional<std::string_view> arg0 = std::nullopt) : ParamsView(cont.begin(), cont.end(), std::move(arg0)) {}
+
+		[[nodiscard]] auto begin() const { return _first; }														///< @brief Retrieve an iterator to the first argument.			@returns ContainerType::const_iterator
+		[[nodiscard]] auto end() const { return _last; }														///< @brief Retrieve an iterator to one past the last argument.	@returns ContainerType::const_iterator
+		[[nodiscard]] size_t size() const { return static_cast<size_t>(_last - _first); }						///< @brief Retrieve the number of arguments.						@returns size_t
+		[[nodiscard]] bool empty() const { return _first == _last; }											///< @brief Check if there are no arguments.						@returns bool
+		[[nodiscard]] const VariantArgument& at(const size_t& pos) const { return *(_first + static_cast<ptrdiff_t>(pos)); }	///< @brief Retrieve the argument at a given index.	@returns const VariantArgument&
+		[[nodiscard]] auto arg0() const { return _arg0; }														///< @brief Retrieve argv[0], if it is known.						@returns std::optional<std::string_view>
+
+		/**
+		 * @brief Retrieve an iterator to an argument in the view.
+		 * @param arg	- Argument name to search for.
+		 * @param off	- Position in the view to begin searching at.
+		 * @param type	- When not MONOSTATE, only arguments of this type are matched.
+		 * @returns ContainerType::const_iterator
+		 */
+		[[nodiscard]] ContainerType::const_iterator find(const std::string_view arg, ContainerType::const_iterator off, const Type type = Type::MONOSTATE) const
+		{
+			return std::find_if(off, _last, [&arg, &type](const VariantArgument& elem) {
+				return (type == Type::MONOSTATE || elem.type() == type) && elem.name_view() == arg;
+				});
+		}
+		/**
+		 * @brief Retrieve an iterator to an argument in the view.
+		 * @param arg	- Argument name to search for.
+		 * @returns ContainerType::const_iterator
+		 */
+		[[nodiscard]] ContainerType::const_iterator find(const auto& arg) const { return find(to_view(arg), _first); }
+		/**
+		 * @brief Retrieve an iterator to an argument with a specific type in the view.
+		 * @tparam SearchTy	- Parameter / Option / Flag
+		 * @param arg		- Argument name to search for.
+		 * @param off		- Position in the view to begin searching at.
+		 * @returns ContainerType::const_iterator
+		 */
+		template<ValidArgumentType SearchTy> [[nodiscard]] ContainerType::const_iterator find(const auto& arg, ContainerType::const_iterator off) const { return find(to_view(arg), off, determineVariantType<SearchTy>()); }
+		/**
+		 * @brief Retrieve an iterator to an argument with a specific type in the view.
+		 * @tparam SearchTy	- Parameter / Option / Flag
+		 * @param arg		- Argument name to search for.
+		 * @returns ContainerType::const_iterator
+		 */
+		template<ValidArgumentType SearchTy> [[nodiscard]] ContainerType::const_iterator find(const auto& arg) const { return find<SearchTy>(arg, _first); }
+
+		/**
+		 * @brief Check if an argument with any type is present in the view.
+		 * @param arg	- Argument name to search for.
+		 * @returns bool
+		 */
+		[[nodiscard]] bool check(const auto& arg) const { return find(arg) != _last; }
+		/**
+		 * @brief Check if an argument with a specified type is present in the view.
+		 * @tparam SearchTy	- Parameter / Option / Flag
+		 * @param arg		- Argument name to search for.
+		 * @returns bool
+		 */
+		template<ValidArgumentType SearchTy> [[nodiscard]] bool check(const auto& arg) const { return find<SearchTy>(arg) != _last; }
+		[[nodiscard]] bool check_opt(const std::string_view arg) const { return check<Option>(arg); }		///< @brief Check if a specified Option is present in the view.		@returns bool
+		[[nodiscard]] bool check_param(const std::string_view arg) const { return check<Parameter>(arg); }	///< @brief Check if a specified Parameter is present in the view.	@returns bool
+		[[nodiscard]] bool check_flag(const char arg) const { return check<Flag>(arg); }					///< @brief Check if a specified Flag is present in the view.		@returns bool
+
+		/**
+		 * @brief Get the captured value of an argument in the view.
+		 * @param arg	- Argument name to search for.
+		 * @returns std::optional<std::string_view>
+		 */
+		[[nodiscard]] std::optional<std::string_view> getv(const auto& arg) const
+		{
+			if (const auto pos{ find(arg) }; pos != _last && pos->hasv())
+				return *pos->capture();
+			return std::nullopt;
+		}
+		/**
+		 * @brief Get the captured value of an argument with a specific type in the view.
+		 * @tparam SearchTy	- Option / Flag
+		 * @param arg		- Argument name to search for.
+		 * @returns std::optional<std::string_view>
+		 */
+		template<class SearchTy> requires std::is_same_v<SearchTy, Option> || std::is_same_v<SearchTy, Flag>
+		[[nodiscard]] std::optional<std::string_view> getv(const auto& arg) const
+		{
+			if (const auto pos{ find<SearchTy>(arg) }; pos != _last && pos->hasv())
+				return *pos->capture();
+			return std::nullopt;
+		}
+	};
+}
\ No newline at end of file
@@ -6,7 +6,9 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <string_view>
 #include <strmanip.hpp>
+#include <opthash.hpp>
 
 namespace opt {
 	inline static const std::string _DEFAULT_OPT_DELIMITERS{ "-" };
@@ -39,7 +41,7 @@ namespace opt {
 		 * @param max	- Max counter value before returning, even if there are more delimiters.
 		 * @returns size_t
 		 */
-		inline size_t countPrefix(const std::string& str, const size_t off = 0u, const size_t max = 2u) const
+		inline size_t countPrefix(const std::string_view str, const size_t off = 0u, const size_t max = 2u) const
 		{
 			size_t count{ 0u };
 			for (auto i{ 0u }; i < str.size() && i < max; ++i)
@@ -54,11 +56,11 @@ namespace opt {
 		 *\n		true	- Char is present.
 		 *\n		false	- Char is not present.
 		 */
-		inline bool allowCapture(std::string str) const
+		inline bool allowCapture(std::string_view str) const
 		{
 			if (str.empty() || _capture_list.empty())
 				return false;
-			str = str.substr(countPrefix(str));
+			str.remove_prefix(countPrefix(str));
 			for (auto& it : _capture_list)
 				if (it == str)
 					return true;
@@ -73,7 +75,25 @@ namespace opt {
 		 */
 		inline bool allowCapture(const char c) const
 		{
-			return allowCapture(std::string(1u, c));
+			if (isDelim(c)) // the prefix is removed before comparing, which leaves an empty string
+				return allowCapture(std::string_view{ &c, 1u });
+			for (auto& it : _capture_list)
+				if (it.size() == 1u && it.front() == c)
+					return true;
+			return false;
+		}
+
+		/**
+		 * @brief Retrieve a hash of every setting that affects the output of parseArgs. Two configs with the same fingerprint produce the same results.
+		 * @returns uint64_t
+		 */
+		inline uint64_t fingerprint() const noexcept
+		{
+			auto hash{ fnv1a(_type_delims) };
+			hash = fnv1a(_allow_negative_numbers, hash);
+			for (auto& it : _capture_list)
+				hash = fnv1a(it.size(), fnv1a(it, hash)); // include the length so that {"ab","c"} & {"a","bc"} differ
+			return hash;
 		}
 	};
 
@@ -0,0 +1,94 @@
+/**
+ * @file StartupContext.hpp
+ * @author radj307
+ * @brief Contains the StartupContext class, which parses the environment & resolves the location of the executable on background threads during startup.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <EnvView.hpp>
+#include <optenv.hpp>
+#include <resolve-path.hpp>
+#include <future>
+#include <system_error>
+#ifdef SHARED_LIB
+
+namespace opt {
+	/**
+	 * @class StartupContext
+	 * @brief Starts indexing the environment & resolving the location of the executable as soon as it is constructed, so that the work
+	 *\n	  overlaps with parsing argv & any other startup logic on the main thread.
+	 *\n	  Each accessor only blocks if its result isn't ready yet, & rethrows any exception thrown while producing it.
+	 *\n	  The argv & envp arrays passed to the constructor must outlive this instance.
+	 *\n	  Use env_view() for list variables such as PATH; Env only splits lists on ';', so its PATH() throws on Linux.
+	 * @code
+	 * int main(const int argc, char** argv, char** envp)
+	 * {
+	 *     opt::StartupContext startup{ argv, envp };
+	 *     opt::ParamsAPI args{ argc, argv, ... };			// runs while the environment is being parsed
+	 *     const auto PATH{ startup.env_view().PATH() };	// blocks only if the index isn't ready yet
+	 * }
+	 * @endcode
+	 */
+	class StartupContext {
+		std::shared_future<EnvView> _env_view;		///< @brief Zero-copy index of envp.
+		std::shared_future<Env> _env;				///< @brief Parsed copy of envp.
+		std::shared_future<ResolvedPath> _exe;		///< @brief Location of the running executable.
+
+		/**
+		 * @brief Run a function on a new thread. If the thread cannot be created, the function is deferred until its result is requested instead.
+		 * @param policy	- When this doesn't include std::launch::async, the function is always deferred.
+		 * @param fn		- Function to run.
+		 * @returns std::shared_future<std::invoke_result_t<Fn>>
+		 */
+		template<class Fn>
+		static std::shared_future<std::invoke_result_t<Fn>> launch(const std::launch policy, Fn&& fn)
+		{
+			if ((policy & std::launch::async) == std::launch::async) {
+				try {
+					return std::async(std::launch::async, fn).share();
+				} catch (const std::system_error&) {}
+			}
+			return std::async(std::launch::deferred, std::forward<Fn>(fn)).share();
+		}
+
+	public:
+		/**
+		 * @brief Constructor that starts the background work.
+		 * @param argv	- argv[] from main(). Only argv[0] is used, to resolve the location of the executable.
+		 * @param envp		- envp[] from main().
+		 * @param policy	- Use std::launch::deferred to do all of the work on the calling thread, the first time each result is requested.
+		 */
+		StartupContext(char** argv, char** envp, const std::launch policy = std::launch::async) :
+			_env_view{ launch(policy, [envp]() { return EnvView{ envp }; }) },
+			_env{ launch(policy, [envp]() { return Env{ envp }; }) },
+			_exe{ launch(policy, [arg0 = std::string{ argv != nullptr && argv[0] != nullptr ? argv[0] : "" }, env_view = _env_view]() {
+				if (auto result{ resolve_executable_without_path(arg0) }; result.has_value())
+					return std::move(result.value());
+				return resolve_executable_in_path(path_list(env_view.get()), arg0);
+			}) }
+		{}
+
+		/**
+		 * @brief Retrieve the zero-copy environment index, blocking until it is ready.
+		 * @returns const EnvView&
+		 */
+		[[nodiscard]] const EnvView& env_view() const { return _env_view.get(); }
+		/**
+		 * @brief Retrieve the parsed environment, blocking until it is ready.
+		 * @returns const Env&
+		 */
+		[[nodiscard]] const Env& env() const { return _env.get(); }
+		/**
+		 * @brief Retrieve the location of the running executable, blocking until it has been resolved.
+		 * @returns const ResolvedPath&	- The strategy is NONE if PATH had to be scanned & didn't contain argv[0].
+		 */
+		[[nodiscard]] const ResolvedPath& executable() const { return _exe.get(); }
+
+		[[nodiscard]] bool env_view_ready() const { return _env_view.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }	///< @brief Check if env_view() can be called without blocking.		@returns bool
+		[[nodiscard]] bool env_ready() const { return _env.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }				///< @brief Check if env() can be called without blocking.			@returns bool
+		[[nodiscard]] bool executable_ready() const { return _exe.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }		///< @brief Check if executable() can be called without blocking.	@returns bool
+	};
+}
+#else
+#error StartupContext.hpp requires the shared library!
+#endif
\ No newline at end of file
@@ -6,10 +6,12 @@
 #pragma once
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <vector>
 #include <variant>
 #include <VariantType.hpp>
+#include <opthash.hpp>
 
 namespace opt {
 	/**
@@ -20,6 +22,7 @@ namespace opt {
 	private:
 		VariantType _arg; ///< @brief The argument of this instance, stored in a std::variant.
 		Type _type; ///< @brief The type of this instance.
+		bool _continues_cluster{ false }; ///< @brief When true, this is a flag that was parsed from the same cluster as the flag before it. This doesn't affect comparisons.
 	public:
 		/**
 		 * @brief Default Constructor.
@@ -46,6 +49,58 @@ namespace opt {
 			}
 		}
 
+		/**
+		 * @brief Retrieve a view of the argument/name of this VariantArgument without copying it. Flag views refer to the stored char.
+		 * @returns std::string_view
+		 *\n	The view is only valid for as long as this instance is alive & unmodified.
+		 */
+		std::string_view name_view() const noexcept
+		{
+			switch ( _type ) {
+			case Type::PARAMETER:
+				return *std::get_if<Parameter>(&_arg);
+			case Type::OPTION:
+				return std::get_if<Option>(&_arg)->first;
+			case Type::FLAG:
+				return{ &std::get_if<Flag>(&_arg)->first, 1u };
+			default:
+				return{};
+			}
+		}
+
+		/**
+		 * @brief Retrieve a reference to the captured value of this argument without copying it.
+		 * @returns const std::optional<std::string>&
+		 *\n	Parameters always return an empty optional.
+		 */
+		const std::optional<std::string>& capture() const noexcept
+		{
+			static const std::optional<std::string> none{ std::nullopt };
+			switch (_type) {
+			case Type::FLAG:
+				return std::get_if<Flag>(&_arg)->second;
+			case Type::OPTION:
+				return std::get_if<Option>(&_arg)->second;
+			default:
+				return none;
+			}
+		}
+
+		/**
+		 * @brief Retrieve a stable 64-bit hash of this argument's type, name & capture. Equal arguments always have the same fingerprint.
+		 * @returns uint64_t
+		 */
+		uint64_t fingerprint() const noexcept
+		{
+			const auto& cap{ capture() };
+			const auto name{ name_view() };
+			auto hash{ fnv1a(static_cast<uint8_t>(static_cast<unsigned>(_type) | (cap.has_value() ? 0x4u : 0x0u))) };
+			hash = fnv1a(static_cast<uint64_t>(name.size()), fnv1a(name, hash)); // include the length as a uint64_t, so that fingerprints match on 32 & 64-bit platforms & so that the name & capture can't be shifted into each other
+			if (cap.has_value())
+				hash = fnv1a(static_cast<uint64_t>(cap->size()), fnv1a(cap.value(), hash));
+			return hash;
+		}
+
 		/**
 		 * @brief Check if this argument has a captured parameter.
 		 * @returns bool
@@ -75,6 +130,18 @@ namespace opt {
 		 */
 		Type type() const { return _type; }
 
+		/**
+		 * @brief Check if this is a flag that was parsed from the same cluster as the flag before it, such as 'b' in "-ab".
+		 *\n	  This is used by render_argv to keep flag clusters intact, & is false for arguments that weren't produced by parseArgs.
+		 * @returns bool
+		 */
+		bool continues_cluster() const { return _continues_cluster; }
+		/**
+		 * @brief Set whether this is a flag that was parsed from the same cluster as the flag before it.
+		 * @param state	- The new state.
+		 */
+		void set_continues_cluster(const bool state) { _continues_cluster = state; }
+
 		/**
 		 * @brief Retrieve this instance's argument of type Parameter.
 		 * @tparam T	- Parameter type.
@@ -257,4 +324,11 @@ namespace opt {
 			return std::get<Flag>(_arg);
 		}
 	};
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Hash specialization for opt::VariantArgument, which uses VariantArgument::fingerprint().
+ */
+template<> struct std::hash<opt::VariantArgument> {
+	size_t operator()(const opt::VariantArgument& arg) const noexcept { return static_cast<size_t>(arg.fingerprint()); }
+};
\ No newline at end of file
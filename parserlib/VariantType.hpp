@@ -3,6 +3,7 @@
 #include <utility>
 #include <variant>
 #include <optional>
+#include <stdexcept>
 namespace opt {
 	using Parameter = std::string;										///< @brief The type used to store parameters from the commandline in a VariantArgument.
 	using Option = std::pair<std::string, std::optional<std::string>>;	///< @brief The type used to store options (long-opts) from the commandline in a VariantArgument.
@@ -43,7 +44,7 @@ namespace opt {
 		case 3: // type is Flag
 			return Type::FLAG;
 		default:
-			throw std::exception("Unknown variant index! (Was a type added?)");
+			throw std::runtime_error("Unknown variant index! (Was a type added?)");
 		}
 	}
 	/**
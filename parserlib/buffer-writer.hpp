@@ -0,0 +1,49 @@
+/**
+ * @file buffer-writer.hpp
+ * @author radj307
+ * @brief Contains the BufferWriter class, which writes into a fixed-size, caller-provided buffer without allocating.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace opt {
+	/**
+	 * @class BufferWriter
+	 * @brief Writes into a fixed-size, caller-provided buffer. Output that doesn't fit is discarded, but still counted, so that
+	 *\n	  size() always returns the number of bytes required to hold the complete output, like std::snprintf.
+	 *\n	  Provides the same push_back & append methods as std::string, so it can be used with any of the serialize functions.
+	 */
+	class BufferWriter {
+		char* _data;		///< @brief Start of the buffer.
+		size_t _capacity;	///< @brief Size of the buffer.
+		size_t _size{ 0u };	///< @brief Number of bytes written, including those that were discarded.
+
+	public:
+		/**
+		 * @brief Constructor.
+		 * @param data		- Start of the buffer. May be nullptr if capacity is 0, which only measures the output.
+		 * @param capacity	- Size of the buffer.
+		 */
+		constexpr BufferWriter(char* data, const size_t capacity) noexcept : _data{ data }, _capacity{ capacity } {}
+
+		constexpr void push_back(const char ch) noexcept
+		{
+			if (_size < _capacity)
+				_data[_size] = ch;
+			++_size;
+		}
+		void append(const std::string_view str) noexcept
+		{
+			if (_size < _capacity)
+				std::memcpy(_data + _size, str.data(), std::min(str.size(), _capacity - _size));
+			_size += str.size();
+		}
+
+		[[nodiscard]] constexpr size_t size() const noexcept { return _size; }							///< @brief Retrieve the number of bytes required for the output so far.	@returns size_t
+		[[nodiscard]] constexpr bool overflowed() const noexcept { return _size > _capacity; }			///< @brief Check if any output was discarded.								@returns bool
+		[[nodiscard]] constexpr std::string_view view() const noexcept { return{ _data, std::min(_size, _capacity) }; }	///< @brief Retrieve the bytes that were written.	@returns std::string_view
+	};
+}
\ No newline at end of file
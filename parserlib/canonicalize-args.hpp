@@ -0,0 +1,100 @@
+/**
+ * @file canonicalize-args.hpp
+ * @author radj307
+ * @brief Contains functions that convert parsed arguments to a canonical form, so that commandlines with the same meaning compare equal.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <algorithm>
+#include <parseArgs.hpp>
+
+namespace opt {
+	/**
+	 * @brief Retrieve the arguments of a range in canonical order, without copying them.
+	 *\n	  Canonical order is defined as:
+	 *\n	  - Options, sorted by name, followed by flags, sorted by name.
+	 *\n	  - Repeated options & flags are removed, keeping only the first occurrence. (& its capture)
+	 *\n	    This matches ParamsAPI, where find(), check() & getv() all use the first match, so canonically equal ranges answer those queries the same way.
+	 *\n	    Queries that see every occurrence, such as typegetv_all(), can still differ.
+	 *\n	  - Parameters, in their original order. Parameters are never removed.
+	 * @param first	- Iterator to the first argument.
+	 * @param last	- Iterator to one past the last argument.
+	 * @returns std::vector<const VariantArgument*>	- Pointers to the arguments in the range.
+	 */
+	inline std::vector<const VariantArgument*> canonical_order(const ContainerType::const_iterator& first, const ContainerType::const_iterator& last)
+	{
+		std::vector<const VariantArgument*> vec;
+		vec.reserve(static_cast<size_t>(last - first));
+		for (auto it{ first }; it != last; ++it)
+			if (it->type() != Type::PARAMETER)
+				vec.emplace_back(&*it);
+		// stable, so that repeated arguments stay in the order they appeared in
+		std::stable_sort(vec.begin(), vec.end(), [](const VariantArgument* l, const VariantArgument* r) {
+			return l->type() != r->type() ? l->type() < r->type() : l->name_view() < r->name_view();
+			});
+		// keep the first argument of each run of repeated arguments
+		vec.erase(std::unique(vec.begin(), vec.end(), [](const VariantArgument* l, const VariantArgument* r) { return l->type() == r->type() && l->name_view() == r->name_view(); }), vec.end());
+		for (auto it{ first }; it != last; ++it)
+			if (it->type() == Type::PARAMETER)
+				vec.emplace_back(&*it);
+		return vec;
+	}
+
+	/**
+	 * @brief Retrieve a copy of a range of arguments in canonical form. See canonical_order().
+	 * @param first	- Iterator to the first argument.
+	 * @param last	- Iterator to one past the last argument.
+	 * @returns ContainerType
+	 */
+	inline ContainerType canonicalize(const ContainerType::const_iterator& first, const ContainerType::const_iterator& last)
+	{
+		const auto order{ canonical_order(first, last) };
+		ContainerType cont;
+		cont.reserve(order.size());
+		for (const auto* arg : order)
+			cont.emplace_back(*arg);
+		return cont;
+	}
+	/**
+	 * @brief Retrieve a copy of an argument container in canonical form. See canonical_order().
+	 * @param cont	- Argument container.
+	 * @returns ContainerType
+	 */
+	inline ContainerType canonicalize(const ContainerType& cont) { return canonicalize(cont.begin(), cont.end()); }
+
+	/**
+	 * @brief Check if two ranges of arguments are equal in canonical form, meaning that they have the same meaning. Neither range is copied.
+	 * @param l_first	- Iterator to the first argument of the left range.
+	 * @param l_last	- Iterator to one past the last argument of the left range.
+	 * @param r_first	- Iterator to the first argument of the right range.
+	 * @param r_last	- Iterator to one past the last argument of the right range.
+	 * @returns bool
+	 */
+	inline bool canonical_equal(const ContainerType::const_iterator& l_first, const ContainerType::const_iterator& l_last, const ContainerType::const_iterator& r_first, const ContainerType::const_iterator& r_last)
+	{
+		const auto l{ canonical_order(l_first, l_last) }, r{ canonical_order(r_first, r_last) };
+		return std::equal(l.begin(), l.end(), r.begin(), r.end(), [](const VariantArgument* a, const VariantArgument* b) { return *a == *b; });
+	}
+	/**
+	 * @brief Check if two argument containers are equal in canonical form, meaning that they have the same meaning. Neither container is copied.
+	 * @param l	- Left container.
+	 * @param r	- Right container.
+	 * @returns bool
+	 */
+	inline bool canonical_equal(const ContainerType& l, const ContainerType& r) { return canonical_equal(l.begin(), l.end(), r.begin(), r.end()); }
+
+	/**
+	 * @brief Calculate the fingerprint of a range of arguments in canonical form, without copying them.
+	 *\n	  Ranges that are canonically equal always have the same canonical fingerprint, which makes this suitable as a cache key.
+	 * @param first	- Iterator to the first argument.
+	 * @param last	- Iterator to one past the last argument.
+	 * @returns uint64_t
+	 */
+	inline uint64_t canonical_fingerprint(const ContainerType::const_iterator& first, const ContainerType::const_iterator& last)
+	{
+		ArgsFingerprint fp;
+		for (const auto* arg : canonical_order(first, last))
+			fp.add(*arg);
+		return fp.value();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ * @file diffArgs.hpp
+ * @author radj307
+ * @brief Contains the diffArgs function, which calculates the differences between two sets of parsed arguments.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <unordered_map>
+#include <ParamsView.hpp>
+
+namespace opt {
+	/**
+	 * @enum EditKind
+	 * @brief The kind of difference described by an ArgEdit.
+	 */
+	enum class EditKind : unsigned char {
+		ADDED,		///< @brief The argument only exists on the right side.
+		REMOVED,	///< @brief The argument only exists on the left side.
+		CHANGED,	///< @brief The argument exists on both sides with a different capture, or is a parameter with a different value at the same position.
+	};
+
+	/**
+	 * @brief Retrieve the name of an EditKind enumerator.
+	 * @param kind	- Input EditKind.
+	 * @returns std::string
+	 */
+	inline std::string get_editname(const EditKind& kind)
+	{
+		using enum EditKind;
+		switch (kind) {
+		case ADDED:
+			return "ADDED";
+		case REMOVED:
+			return "REMOVED";
+		case CHANGED:
+			return "CHANGED";
+		default:
+			return{};
+		}
+	}
+
+	/**
+	 * @struct ArgEdit
+	 * @brief A single difference between two sets of arguments. Refers to the arguments by index rather than copying them.
+	 */
+	struct ArgEdit {
+		static constexpr size_t npos{ static_cast<size_t>(-1) };
+
+		EditKind kind;		///< @brief The kind of difference.
+		Type type;			///< @brief The type of the argument.
+		size_t left;		///< @brief Index of the argument on the left side, or npos if it was ADDED.
+		size_t right;		///< @brief Index of the argument on the right side, or npos if it was REMOVED.
+
+		bool operator==(const ArgEdit&) const = default;
+	};
+
+	/**
+	 * @brief Calculate the differences between two sets of parsed arguments, in time linear in the total number of arguments.
+	 *\n	  Options & flags are matched by type & name, regardless of their position. When an option or flag is repeated, the nth occurrence on each side are matched.
+	 *\n	  Parameters are matched by their position among the other parameters.
+	 *\n	  Edits are returned in the order of the right side's arguments (ADDED & CHANGED), followed by the left side's unmatched arguments. (REMOVED)
+	 * @param l	- Left (old) arguments.
+	 * @param r	- Right (new) arguments.
+	 * @returns std::vector<ArgEdit>	- An empty vector means that both sides are equal.
+	 */
+	inline std::vector<ArgEdit> diffArgs(const ParamsView& l, const ParamsView& r)
+	{
+		struct Key {
+			Type type;
+			std::string_view name;
+			size_t occurrence;
+			bool operator==(const Key&) const = default;
+		};
+		struct KeyHash {
+			size_t operator()(const Key& key) const noexcept { return static_cast<size_t>(fnv1a(key.occurrence, fnv1a(key.name, fnv1a(static_cast<unsigned>(key.type))))); }
+		};
+		const auto occurrence{ [](std::unordered_map<Key, size_t, KeyHash>& counts, const VariantArgument& arg) {
+			return counts[Key{ arg.type(), arg.name_view(), 0u }]++;
+		} };
+
+		// index the left side's options & flags, & the positions of its parameters
+		std::unordered_map<Key, size_t, KeyHash> left, counts;
+		std::vector<size_t> left_params;
+		left.reserve(l.size());
+		for (size_t i{ 0u }; i < l.size(); ++i) {
+			const auto& arg{ l.at(i) };
+			if (arg.type() == Type::PARAMETER)
+				left_params.emplace_back(i);
+			else
+				left.emplace(Key{ arg.type(), arg.name_view(), occurrence(counts, arg) }, i);
+		}
+
+		std::vector<ArgEdit> edits;
+		std::vector<bool> matched(l.size(), false);
+		counts.clear();
+		size_t param_count{ 0u };
+		for (size_t i{ 0u }; i < r.size(); ++i) {
+			const auto& arg{ r.at(i) };
+			if (arg.type() == Type::PARAMETER) {
+				if (const auto n{ param_count++ }; n < left_params.size()) {
+					matched[left_params[n]] = true;
+					if (l.at(left_params[n]).name_view() != arg.name_view())
+						edits.emplace_back(ArgEdit{ EditKind::CHANGED, Type::PARAMETER, left_params[n], i });
+				}
+				else edits.emplace_back(ArgEdit{ EditKind::ADDED, Type::PARAMETER, ArgEdit::npos, i });
+			}
+			else if (const auto it{ left.find(Key{ arg.type(), arg.name_view(), occurrence(counts, arg) }) }; it != left.end()) {
+				matched[it->second] = true;
+				if (l.at(it->second).capture() != arg.capture())
+					edits.emplace_back(ArgEdit{ EditKind::CHANGED, arg.type(), it->second, i });
+			}
+			else edits.emplace_back(ArgEdit{ EditKind::ADDED, arg.type(), ArgEdit::npos, i });
+		}
+		for (size_t i{ 0u }; i < l.size(); ++i)
+			if (!matched[i])
+				edits.emplace_back(ArgEdit{ EditKind::REMOVED, l.at(i).type(), i, ArgEdit::npos });
+		return edits;
+	}
+}
\ No newline at end of file
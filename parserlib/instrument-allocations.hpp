@@ -0,0 +1,267 @@
+/**
+ * @file instrument-allocations.hpp
+ * @author radj307
+ * @brief Optional instrumentation that attributes heap allocations to the public entry points of this library.
+ *\n	  Define OPT_INSTRUMENT_ALLOCATIONS to enable the OPT_INSTRUMENT_SCOPE & OPT_INSTRUMENT_EXPR macros, which otherwise expand to nothing.
+ *\n	  Allocations are reported by the global operator new & delete replacements defined by OPT_DEFINE_ALLOCATION_HOOKS,
+ *\n	  which must be defined before including this header in exactly one translation unit.
+ *\n	  Programs that already replace operator new may call on_allocate() & on_deallocate() from their own replacements instead.
+ *\n	  Process-wide totals, such as the number of live heap bytes, are also kept in heap_totals for tools like the benchmarks.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace opt::instrument {
+	/**
+	 * @enum EntryPoint
+	 * @brief The public entry points that allocations can be attributed to.
+	 */
+	enum class EntryPoint : unsigned char {
+		VECTORIZE,		///< @brief vectorize()
+		PARSE_ARGS,		///< @brief parseArgs()
+		PARAMS_API,		///< @brief Constructing a ParamsAPI instance from unparsed arguments.
+		FIND,			///< @brief ParamsAPI::find()
+		CHECK,			///< @brief ParamsAPI::check()
+		GETV,			///< @brief ParamsAPI::getv()
+		PARSE_ENVP,		///< @brief parse_envp()
+		RESOLVE_PATH,	///< @brief resolve_path()
+	};
+	/// @brief Number of values in EntryPoint.
+	inline constexpr size_t ENTRY_POINT_COUNT{ 8u };
+
+	/**
+	 * @brief Returns an EntryPoint as plaintext.
+	 * @param entry	- Entry point to convert.
+	 * @returns std::string
+	 */
+	inline std::string get_entryname(const EntryPoint& entry)
+	{
+		using enum EntryPoint;
+		switch (entry) {
+		case VECTORIZE:
+			return "vectorize";
+		case PARSE_ARGS:
+			return "parseArgs";
+		case PARAMS_API:
+			return "ParamsAPI";
+		case FIND:
+			return "find";
+		case CHECK:
+			return "check";
+		case GETV:
+			return "getv";
+		case PARSE_ENVP:
+			return "parse_envp";
+		case RESOLVE_PATH:
+			return "resolve_path";
+		default:
+			return{};
+		}
+	}
+
+	/**
+	 * @struct AllocationStats
+	 * @brief Allocations attributed to one entry point, totalled across every thread. Nested entry points are included in the totals of their callers.
+	 */
+	struct AllocationStats {
+		uint64_t calls{ 0u };		///< @brief Number of times the entry point was called.
+		uint64_t allocations{ 0u };	///< @brief Number of calls to operator new during those calls.
+		uint64_t bytes{ 0u };		///< @brief Number of bytes requested from operator new during those calls.
+		uint64_t peak_bytes{ 0u };	///< @brief Largest increase of live heap bytes reached during any single call.
+
+		/// @brief Returns the average number of allocations per call.	@returns double
+		[[nodiscard]] double allocations_per_call() const { return calls == 0u ? 0.0 : static_cast<double>(allocations) / static_cast<double>(calls); }
+		/// @brief Returns the average number of allocated bytes per call.	@returns double
+		[[nodiscard]] double bytes_per_call() const { return calls == 0u ? 0.0 : static_cast<double>(bytes) / static_cast<double>(calls); }
+	};
+
+	namespace _internal {
+		struct Counters {
+			std::atomic<uint64_t> calls{ 0u }, allocations{ 0u }, bytes{ 0u }, peak_bytes{ 0u };
+		};
+		inline Counters counters[ENTRY_POINT_COUNT];
+
+		/// @brief Allocations made by the current thread. This is constant-initialized, so it is safe to use from operator new before main().
+		struct ThreadState {
+			uint64_t allocations{ 0u }, bytes{ 0u };
+			int64_t live{ 0 }, peak{ 0 };
+		};
+		inline thread_local ThreadState thread_state;
+	}
+
+	/**
+	 * @struct HeapTotals
+	 * @brief Allocations reported by every thread since the program started.
+	 */
+	struct HeapTotals {
+		std::atomic<uint64_t> allocations{ 0u };	///< @brief Number of calls to operator new.
+		std::atomic<uint64_t> bytes{ 0u };			///< @brief Number of bytes requested from operator new.
+		std::atomic<int64_t> live{ 0 };				///< @brief Number of bytes allocated by operator new that haven't been deleted yet.
+	};
+	/// @brief Allocations reported to on_allocate() & on_deallocate() by every thread.
+	inline HeapTotals heap_totals;
+
+	/**
+	 * @brief Report an allocation to the instrumentation. This is called by the operator new replacement.
+	 * @param size	- Number of bytes allocated.
+	 */
+	inline void on_allocate(const size_t size) noexcept
+	{
+		auto& state{ _internal::thread_state };
+		++state.allocations;
+		state.bytes += size;
+		state.live += static_cast<int64_t>(size);
+		state.peak = std::max(state.peak, state.live);
+		heap_totals.allocations.fetch_add(1u, std::memory_order_relaxed);
+		heap_totals.bytes.fetch_add(size, std::memory_order_relaxed);
+		heap_totals.live.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+	}
+	/**
+	 * @brief Report a deallocation to the instrumentation. This is called by the operator delete replacement.
+	 * @param size	- Number of bytes deallocated.
+	 */
+	inline void on_deallocate(const size_t size) noexcept
+	{
+		_internal::thread_state.live -= static_cast<int64_t>(size);
+		heap_totals.live.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+	}
+
+	/**
+	 * @class Scope
+	 * @brief RAII object that attributes every allocation made by the current thread during its lifetime to an entry point.
+	 */
+	class Scope {
+		EntryPoint _entry;
+		uint64_t _allocations, _bytes;
+		int64_t _live, _outer_peak;
+
+	public:
+		/**
+		 * @brief Constructor.
+		 * @param entry	- Entry point to attribute allocations to.
+		 */
+		explicit Scope(const EntryPoint entry) noexcept : _entry{ entry }, _allocations{ _internal::thread_state.allocations }, _bytes{ _internal::thread_state.bytes }, _live{ _internal::thread_state.live }, _outer_peak{ _internal::thread_state.peak }
+		{
+			_internal::thread_state.peak = _live; // track the peak of this scope separately, & restore the enclosing peak afterwards
+		}
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		~Scope() noexcept
+		{
+			auto& state{ _internal::thread_state };
+			auto& counters{ _internal::counters[static_cast<size_t>(_entry)] };
+			counters.calls.fetch_add(1u, std::memory_order_relaxed);
+			counters.allocations.fetch_add(state.allocations - _allocations, std::memory_order_relaxed);
+			counters.bytes.fetch_add(state.bytes - _bytes, std::memory_order_relaxed);
+			const auto peak{ static_cast<uint64_t>(std::max<int64_t>(state.peak - _live, 0)) };
+			for (auto prev{ counters.peak_bytes.load(std::memory_order_relaxed) }; prev < peak && !counters.peak_bytes.compare_exchange_weak(prev, peak, std::memory_order_relaxed);) {}
+			state.peak = std::max(_outer_peak, state.peak);
+		}
+	};
+
+	/**
+	 * @brief Call a function inside of a Scope, for attributing allocations made by expressions that cannot contain a Scope, such as member initializers.
+	 * @param entry	- Entry point to attribute allocations to.
+	 * @param fn	- Function to call.
+	 * @returns auto	- The value returned by fn.
+	 */
+	template<class Fn>
+	inline auto measure(const EntryPoint entry, Fn&& fn)
+	{
+		const Scope scope{ entry };
+		return fn();
+	}
+
+	/**
+	 * @brief Retrieve the allocations attributed to an entry point.
+	 * @param entry	- Entry point.
+	 * @returns AllocationStats
+	 */
+	inline AllocationStats get_stats(const EntryPoint entry) noexcept
+	{
+		const auto& counters{ _internal::counters[static_cast<size_t>(entry)] };
+		return{
+			counters.calls.load(std::memory_order_relaxed),
+			counters.allocations.load(std::memory_order_relaxed),
+			counters.bytes.load(std::memory_order_relaxed),
+			counters.peak_bytes.load(std::memory_order_relaxed),
+		};
+	}
+
+	/**
+	 * @brief Reset the allocations attributed to every entry point. This should not be called while another thread is inside of a Scope.
+	 */
+	inline void reset_stats() noexcept
+	{
+		for (auto& counters : _internal::counters) {
+			counters.calls.store(0u, std::memory_order_relaxed);
+			counters.allocations.store(0u, std::memory_order_relaxed);
+			counters.bytes.store(0u, std::memory_order_relaxed);
+			counters.peak_bytes.store(0u, std::memory_order_relaxed);
+		}
+	}
+}
+
+#ifdef OPT_INSTRUMENT_ALLOCATIONS
+/// @brief Attribute every allocation made until the end of the enclosing block to an EntryPoint.
+#define OPT_INSTRUMENT_SCOPE(entry) const ::opt::instrument::Scope _opt_instrument_scope{ ::opt::instrument::EntryPoint::entry }
+/// @brief Attribute every allocation made while evaluating an expression to an EntryPoint.
+#define OPT_INSTRUMENT_EXPR(entry, ...) ::opt::instrument::measure(::opt::instrument::EntryPoint::entry, [&]() { return __VA_ARGS__; })
+#else
+#define OPT_INSTRUMENT_SCOPE(entry)
+#define OPT_INSTRUMENT_EXPR(entry, ...) __VA_ARGS__
+#endif
+
+#ifdef OPT_DEFINE_ALLOCATION_HOOKS
+namespace opt::instrument::_internal {
+	/// @brief Each allocation is prefixed with its size, so that operator delete can report it even when the size is not passed.
+	inline constexpr size_t HEADER_SIZE{ alignof(std::max_align_t) };
+
+	inline void* allocate(const size_t size) noexcept
+	{
+		auto* block{ static_cast<unsigned char*>(std::malloc(size + HEADER_SIZE)) };
+		if (block == nullptr)
+			return nullptr;
+		*reinterpret_cast<size_t*>(block) = size;
+		on_allocate(size);
+		return block + HEADER_SIZE;
+	}
+	inline void deallocate(void* ptr) noexcept
+	{
+		if (ptr == nullptr)
+			return;
+		auto* block{ static_cast<unsigned char*>(ptr) - HEADER_SIZE };
+		on_deallocate(*reinterpret_cast<size_t*>(block));
+		std::free(block);
+	}
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // operator new is implemented with malloc, so free is the correct match
+#endif
+void* operator new(const size_t size)
+{
+	if (void* ptr{ opt::instrument::_internal::allocate(size) })
+		return ptr;
+	throw std::bad_alloc{};
+}
+void* operator new[](const size_t size) { return operator new(size); }
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return opt::instrument::_internal::allocate(size); }
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept { return opt::instrument::_internal::allocate(size); }
+void operator delete(void* ptr) noexcept { opt::instrument::_internal::deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { opt::instrument::_internal::deallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { opt::instrument::_internal::deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { opt::instrument::_internal::deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { opt::instrument::_internal::deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { opt::instrument::_internal::deallocate(ptr); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
\ No newline at end of file
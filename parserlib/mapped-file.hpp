@@ -0,0 +1,167 @@
+/**
+ * @file mapped-file.hpp
+ * @author radj307
+ * @brief Contains the MappedFile class, a read-only view of a file's contents that is memory-mapped where the platform allows it.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace opt {
+	/**
+	 * @class MappedFile
+	 * @brief Read-only view of a file's contents. On POSIX systems the file is mapped with mmap, otherwise it is read into an internal buffer.
+	 *\n	  Files that cannot be mapped (such as those in /proc) fall back to being read.
+	 */
+	class MappedFile {
+		const char* _data{ nullptr };	///< @brief Pointer to the first byte of the file contents.
+		size_t _size{ 0u };				///< @brief Size of the file contents in bytes.
+		bool _mapped{ false };			///< @brief When true, _data points to a mapping that must be released with munmap.
+		std::string _buffer;			///< @brief Holds the file contents when mapping is unavailable.
+
+		void release() noexcept
+		{
+		#if defined(__linux__) || defined(__APPLE__)
+			if (_mapped)
+				munmap(const_cast<char*>(_data), _size);
+		#endif
+			_data = nullptr;
+			_size = 0u;
+			_mapped = false;
+			_buffer.clear();
+		}
+
+		bool read(const std::filesystem::path& path)
+		{
+			std::ifstream ifs{ path, std::ios_base::binary };
+			if (!ifs.is_open())
+				return false;
+			_buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+			_data = _buffer.data();
+			_size = _buffer.size();
+			return true;
+		}
+
+	public:
+		/**
+		 * @brief Default Constructor. Creates an empty, invalid instance.
+		 */
+		MappedFile() = default;
+		/**
+		 * @brief Constructor that maps the given file.
+		 * @param path	- Path to the target file.
+		 */
+		explicit MappedFile(const std::filesystem::path& path) { open(path); }
+	#if defined(__linux__) || defined(__APPLE__)
+		/**
+		 * @brief Constructor that maps an already-open file descriptor, such as a memfd. The descriptor is not closed.
+		 * @param fd	- Open file descriptor.
+		 */
+		explicit MappedFile(const int fd) { open(fd); }
+	#endif
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& o) noexcept { *this = std::move(o); }
+		~MappedFile() { release(); }
+
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& o) noexcept
+		{
+			if (this != &o) {
+				release();
+				_mapped = o._mapped;
+				_buffer = std::move(o._buffer);
+				_size = o._size;
+				_data = _mapped ? o._data : _buffer.data();
+				o._data = nullptr;
+				o._size = 0u;
+				o._mapped = false;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Map the given file, releasing any previous contents.
+		 * @param path	- Path to the target file.
+		 * @returns bool
+		 *\n		true	- The file is open, and its contents are available through view().
+		 *\n		false	- The file could not be opened.
+		 */
+		bool open(const std::filesystem::path& path)
+		{
+			release();
+		#if defined(__linux__) || defined(__APPLE__)
+			if (const int fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) }; fd != -1) {
+				const bool ok{ open(fd) };
+				::close(fd);
+				if (ok)
+					return true;
+			}
+		#endif
+			return read(path);
+		}
+
+	#if defined(__linux__) || defined(__APPLE__)
+		/**
+		 * @brief Map an already-open file descriptor, releasing any previous contents. The descriptor is not closed.
+		 * @param fd	- Open file descriptor.
+		 * @returns bool
+		 */
+		bool open(const int fd)
+		{
+			release();
+			struct stat st{};
+			if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) // empty files cannot be mapped, & procfs files always report a size of 0
+				return false;
+			// a private read-only mapping is allowed on sealed memfds opened for writing, where a shared mapping fails with EPERM on older kernels
+			if (void* addr{ mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0) }; addr != MAP_FAILED) {
+				_data = static_cast<const char*>(addr);
+				_size = static_cast<size_t>(st.st_size);
+				_mapped = true;
+				return true;
+			}
+			return false;
+		}
+	#endif
+
+		[[nodiscard]] bool is_open() const noexcept { return _data != nullptr; }			///< @brief Check if this instance has valid contents.	@returns bool
+		[[nodiscard]] bool is_mapped() const noexcept { return _mapped; }					///< @brief Check if the contents are memory-mapped.	@returns bool
+		[[nodiscard]] const char* data() const noexcept { return _data; }					///< @brief Retrieve a pointer to the contents.			@returns const char*
+		[[nodiscard]] size_t size() const noexcept { return _size; }						///< @brief Retrieve the size of the contents.			@returns size_t
+		[[nodiscard]] std::string_view view() const noexcept { return{ _data, _size }; }	///< @brief Retrieve the contents as a string_view.		@returns std::string_view
+	};
+	/**
+	 * @brief Replace the contents of a file by writing them to a temporary file next to it & renaming that over the target,
+	 *\n	  so concurrent readers see either the old or the new contents, never a partial write. The temporary file is removed if any step fails.
+	 * @param path		- Path to the target file.
+	 * @param contents	- New contents of the file.
+	 * @returns bool
+	 *\n		true	- The file was written.
+	 *\n		false	- The file could not be written, & was left unchanged.
+	 */
+	inline bool write_file_atomic(const std::filesystem::path& path, const std::string_view contents)
+	{
+		auto tmp_path{ path };
+		tmp_path += '.' + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+		std::error_code ec;
+		if (std::ofstream ofs{ tmp_path, std::ios_base::binary | std::ios_base::trunc }; !ofs.is_open() || !ofs.write(contents.data(), static_cast<std::streamsize>(contents.size())) || !ofs.flush()) {
+			ofs.close();
+			std::filesystem::remove(tmp_path, ec);
+			return false;
+		}
+		std::filesystem::rename(tmp_path, path, ec);
+		if (ec)
+			std::filesystem::remove(tmp_path, ec);
+		return !ec;
+	}
+}
\ No newline at end of file
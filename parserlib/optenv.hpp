@@ -5,9 +5,12 @@
  */
 #pragma once
 #include <OPT_PARSER_LIB.h>
+#include <stdexcept>
 #include <unordered_map>
 #include <strmanip.hpp>
 #include <strconv.hpp>
+#include <EnvView.hpp>
+#include <instrument-allocations.hpp>
 #ifdef SHARED_LIB
 
 namespace opt {
@@ -53,6 +56,8 @@ namespace opt {
 
 	inline EnvContainer parse_envp(char** envp)
 	{
+		OPT_INSTRUMENT_SCOPE(PARSE_ENVP);
+		OPT_TRACE_PHASE(trace::phase::ENVIRONMENT);
 		EnvContainer vec;
 
 		for (unsigned i{ 0u }; envp[i] != nullptr; ++i) {
@@ -77,24 +82,28 @@ namespace opt {
 
 	struct Env {
 		EnvContainer _vars;
-		Env(char** envp) : _vars{ std::move(parse_envp(envp)) } {}
+		EnvIndex _index; ///< @brief Hash index of the names in _vars. Call reindex() after modifying _vars.
+		Env(char** envp) : _vars{ std::move(parse_envp(envp)) } { reindex(); }
 
-		[[nodiscard]] EnvContainer::const_iterator find(std::string var_name, const bool case_sensitive = false) const
+		/// @brief Rebuild the name index. This must be called after _vars is modified.
+		void reindex()
 		{
-			if (!case_sensitive) // convert var name to lowercase if case sensitivity is off
-				var_name = str::tolower(var_name);
-			for (auto it{ _vars.begin() }; it != _vars.end(); ++it) // iterate through all vars
-				if (const auto name{ it->name() }; (case_sensitive && name == var_name) || (!case_sensitive && str::tolower(name) == var_name))
-					return it;
+			_index = EnvIndex{ _vars.begin(), _vars.end(), [](const VariantVariable& var) -> std::string_view { return var._name; } };
+		}
+
+		[[nodiscard]] EnvContainer::const_iterator find(const std::string_view var_name, const bool case_sensitive = false) const
+		{
+			if (const auto pos{ _index.find(var_name, case_sensitive, [this](const size_t i) -> std::string_view { return _vars[i]._name; }) }; pos != EnvIndex::npos)
+				return _vars.begin() + static_cast<ptrdiff_t>(pos);
 			return _vars.end();
 		}
 
-		[[nodiscard]] bool exists(const std::string& var_name, const bool case_sensitive = false) const
+		[[nodiscard]] bool exists(const std::string_view var_name, const bool case_sensitive = false) const
 		{
 			return find(var_name, case_sensitive) != _vars.end();
 		}
 
-		[[nodiscard]] std::optional<VariantVariable> get(const std::string& var_name, const bool case_sensitive = false) const
+		[[nodiscard]] std::optional<VariantVariable> get(const std::string_view var_name, const bool case_sensitive = false) const
 		{
 			if (const auto target{ find(var_name, case_sensitive) }; target != _vars.end())
 				return *target;
@@ -105,20 +114,22 @@ namespace opt {
 		{
 			if (const auto path_var{ find("PATH", false) }; path_var != _vars.end() && path_var->is_array())
 				return path_var->value_array().value();
-			throw std::exception("Failed to find PATH environment variable!");
+			throw std::runtime_error("Failed to find PATH environment variable!");
 		}
 
 		[[nodiscard]] std::string HOME() const
 		{
 			if (const auto home_var{ find("HOME", false) }; home_var != _vars.end() && home_var->is_string())
 				return home_var->value_string().value();
-			throw std::exception("Failed to find HOME environment variable!");
+			throw std::runtime_error("Failed to find HOME environment variable!");
 		}
 	};
 
 	struct Environment {
 		using cont_env = std::unordered_map<std::string, std::string>;
 		cont_env _var;
+		std::vector<const cont_env::value_type*> _entries; ///< @brief Pointers to each element of _var, in the order used by _index. Call reindex() after modifying _var.
+		EnvIndex _index; ///< @brief Case-folded hash index of the names in _var.
 
 		static cont_env parse(char* envp[])
 		{
@@ -129,37 +140,67 @@ namespace opt {
 				if (dPos != std::string::npos)
 					vec[str::strip_line(str.substr(0, dPos), "")] = str::strip_line(str.substr(dPos + 1), "");
 				else
-					throw std::exception("Unknown Environment Variable Syntax");
+					throw std::runtime_error("Unknown Environment Variable Syntax");
 			}
 			return vec;
 		}
 
-		explicit Environment(char* envp[]) : _var{ parse(envp) } {}
+		explicit Environment(char* envp[]) : _var{ parse(envp) } { reindex(); }
+		Environment(const Environment& o) : _var{ o._var } { reindex(); }
+		Environment(Environment&&) noexcept = default; // map nodes are not relocated by a move, so _entries stays valid
+		Environment& operator=(const Environment& o)
+		{
+			_var = o._var;
+			reindex();
+			return *this;
+		}
+		Environment& operator=(Environment&&) noexcept = default;
+
+		/// @brief Rebuild the name index. This must be called after _var is modified.
+		void reindex()
+		{
+			_entries.clear();
+			_entries.reserve(_var.size());
+			for (const auto& it : _var)
+				_entries.emplace_back(&it);
+			_index = EnvIndex{ _entries.begin(), _entries.end(), [](const cont_env::value_type* pr) -> std::string_view { return pr->first; } };
+		}
+
+		/**
+		 * @brief Retrieve a pointer to the element with a given name.
+		 * @param var_name			- Variable name to search for.
+		 * @param case_sensitive	- When false, the name is compared without case sensitivity.
+		 * @returns const cont_env::value_type*	- nullptr if the variable doesn't exist.
+		 */
+		[[nodiscard]] const cont_env::value_type* find(const std::string_view var_name, const bool case_sensitive = false) const
+		{
+			if (const auto pos{ _index.find(var_name, case_sensitive, [this](const size_t i) -> std::string_view { return _entries[i]->first; }) }; pos != EnvIndex::npos)
+				return _entries[pos];
+			return nullptr;
+		}
 
-		[[nodiscard]] bool check(const std::string& var_name, const bool case_sensitive = true)
+		[[nodiscard]] bool check(const std::string_view var_name, const bool case_sensitive = true) const
 		{
-			return std::ranges::any_of(_var, [&var_name, &case_sensitive](const cont_env::value_type
-				& pr) { if (case_sensitive) return str::tolower(pr.first) == str::tolower(var_name); return pr.first == var_name; });
+			return find(var_name, case_sensitive) != nullptr;
 		}
 
-		[[nodiscard]] std::string getv(const std::string& var_name, const bool case_sensitive = false)
+		[[nodiscard]] std::string getv(const std::string_view var_name, const bool case_sensitive = false) const
 		{
+			if (const auto* pr{ find(var_name, case_sensitive) }; pr != nullptr)
+				return pr->second;
 			if (case_sensitive)
-				return _var.at(var_name);
-			const auto res{ std::ranges::find_if(_var, [&var_name](const cont_env::value_type& pr) { return str::tolower(pr.first) == str::tolower(var_name); }) };
-			if (res != _var.end())
-				return res->second;
+				throw std::out_of_range("Environment variable doesn't exist!");
 			return{};
 		}
 
 		[[nodiscard]] std::vector<std::string> getPath() const
 		{
 			std::stringstream PATH{ [this]() -> std::string {
-				try {
-					return _var.at("Path");
-				} catch (...) {
-					return _var.at("PATH");
-				}
+				if (const auto* pr{ find("Path", true) }; pr != nullptr)
+					return pr->second;
+				if (const auto* pr{ find("PATH", true) }; pr != nullptr)
+					return pr->second;
+				throw std::out_of_range("Failed to find PATH environment variable!");
 			}() };
 			std::vector<std::string> vec;
 			const auto push{ [&vec](const std::string& entry) { if (!entry.empty()) vec.push_back(entry); } };
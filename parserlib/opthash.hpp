@@ -0,0 +1,73 @@
+/**
+ * @file opthash.hpp
+ * @author radj307
+ * @brief Contains small, non-cryptographic hashing helpers used to fingerprint configurations & argument containers.
+ */
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace opt {
+	inline constexpr uint64_t FNV_OFFSET_BASIS{ 0xcbf29ce484222325ull };	///< @brief 64-bit FNV-1a offset basis.
+	inline constexpr uint64_t FNV_PRIME{ 0x100000001b3ull };				///< @brief 64-bit FNV-1a prime.
+
+	/**
+	 * @brief Continue a 64-bit FNV-1a hash over a range of bytes.
+	 * @param bytes	- Input bytes.
+	 * @param seed	- Previous hash value, or FNV_OFFSET_BASIS to start a new hash.
+	 * @returns uint64_t
+	 */
+	constexpr uint64_t fnv1a(const std::string_view bytes, uint64_t seed = FNV_OFFSET_BASIS) noexcept
+	{
+		for (const auto& ch : bytes) {
+			seed ^= static_cast<unsigned char>(ch);
+			seed *= FNV_PRIME;
+		}
+		return seed;
+	}
+
+	/**
+	 * @brief Continue a 64-bit FNV-1a hash over the bytes of an integral value.
+	 * @param value	- Input value.
+	 * @param seed	- Previous hash value, or FNV_OFFSET_BASIS to start a new hash.
+	 * @returns uint64_t
+	 */
+	template<class T> requires std::is_integral_v<T>
+	constexpr uint64_t fnv1a(const T value, uint64_t seed = FNV_OFFSET_BASIS) noexcept
+	{
+		for (size_t i{ 0u }; i < sizeof(T); ++i) {
+			seed ^= static_cast<uint64_t>(value >> (i * 8u)) & 0xFFu;
+			seed *= FNV_PRIME;
+		}
+		return seed;
+	}
+
+	/**
+	 * @brief Calculate a 64-bit FNV-1a hash of a string with ASCII letters folded to lowercase, so that strings differing only by case have the same hash.
+	 * @param str	- Input string.
+	 * @param seed	- Previous hash value, or FNV_OFFSET_BASIS to start a new hash.
+	 * @returns uint64_t
+	 */
+	constexpr uint64_t fnv1a_folded(const std::string_view str, uint64_t seed = FNV_OFFSET_BASIS) noexcept
+	{
+		for (const auto& ch : str) {
+			seed ^= static_cast<unsigned char>(ch >= 'A' && ch <= 'Z' ? ch - 'A' + 'a' : ch);
+			seed *= FNV_PRIME;
+		}
+		return seed;
+	}
+
+	/**
+	 * @brief Scramble the bits of a 64-bit hash so that every input bit affects every output bit. (The SplitMix64 finalizer)
+	 *\n	  This is used before combining hashes with addition, which would otherwise let similar inputs cancel each other out.
+	 * @param x	- Input hash.
+	 * @returns uint64_t
+	 */
+	constexpr uint64_t mix64(uint64_t x) noexcept
+	{
+		x = (x ^ (x >> 30u)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27u)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31u);
+	}
+}
\ No newline at end of file
@@ -5,67 +5,290 @@
  */
 #pragma once
 #include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <string_view>
 #include <VariantArgument.hpp>
 #include <ParserConfig.hpp>
+#include <instrument-allocations.hpp>
+#include <trace-phases.hpp>
 
 namespace opt {
 	using ContainerType = std::vector<VariantArgument>;
 
 	/**
-	 * @brief Parse a list of strings into a variant container type.
-	 * @param args			 - argv as a vector
-	 * @param capture_list	 - List of argument names that can capture arguments.
-	 * @param delims		 - String containing all valid opt prefixes (default: '-' or '/')
-	 * @param include_delims - When true, includes prefix delimiters in the argument name
-	 * @returns ContainerType
+	 * @struct ArgsFingerprint
+	 * @brief Incrementally calculates a stable 64-bit fingerprint of a sequence of arguments, in both an order-sensitive & an order-insensitive mode.
+	 *\n	  In the order-insensitive mode, flags & options may appear in any order, but parameters must still appear in the same order.
+	 */
+	struct ArgsFingerprint {
+		uint64_t ordered{ FNV_OFFSET_BASIS };		///< @brief Hash of every argument, in order.
+		uint64_t parameters{ FNV_OFFSET_BASIS };	///< @brief Hash of the parameters, in order.
+		uint64_t unordered{ 0u };					///< @brief Sum of the mixed hashes of every flag & option, which doesn't depend on their order.
+
+		constexpr ArgsFingerprint() = default;
+		/**
+		 * @brief Constructor that adds a range of arguments.
+		 * @param first	- Iterator to the first argument.
+		 * @param last	- Iterator to one past the last argument.
+		 */
+		ArgsFingerprint(ContainerType::const_iterator first, const ContainerType::const_iterator& last) noexcept
+		{
+			for (; first != last; ++first)
+				add(*first);
+		}
+
+		/**
+		 * @brief Add an argument to the end of the sequence.
+		 * @param arg	- Argument to add.
+		 */
+		void add(const VariantArgument& arg) noexcept
+		{
+			const auto hash{ arg.fingerprint() };
+			ordered = fnv1a(hash, ordered);
+			if (arg.type() == Type::PARAMETER)
+				parameters = fnv1a(hash, parameters);
+			else
+				unordered += mix64(hash);
+		}
+
+		/**
+		 * @brief Retrieve the fingerprint.
+		 * @param order_insensitive	- When true, the order of flags & options relative to each other & to parameters is ignored.
+		 * @returns uint64_t
+		 */
+		[[nodiscard]] constexpr uint64_t value(const bool order_insensitive = false) const noexcept
+		{
+			return order_insensitive ? mix64(parameters ^ mix64(unordered)) : ordered;
+		}
+	};
+
+	/**
+	 * @brief Calculate a stable 64-bit fingerprint of a range of arguments.
+	 * @param first				- Iterator to the first argument.
+	 * @param last				- Iterator to one past the last argument.
+	 * @param order_insensitive	- When true, the order of flags & options relative to each other & to parameters is ignored.
+	 * @returns uint64_t
+	 */
+	inline uint64_t fingerprint(const ContainerType::const_iterator& first, const ContainerType::const_iterator& last, const bool order_insensitive = false) noexcept
+	{
+		return ArgsFingerprint{ first, last }.value(order_insensitive);
+	}
+
+	/**
+	 * @struct ParseStats
+	 * @brief Summary of a parsed commandline, for exporting to metrics & spotting pathological commandlines without a profiler.
+	 *\n	  Pass a pointer to an instance to parseArgs or to a ParamsAPI constructor to fill it. Counts & byte totals are added to the existing values,
+	 *\n	  so one instance can summarize several parses, while size & capacity always describe the most recent container.
+	 */
+	struct ParseStats {
+		size_t parameters{ 0u };		///< @brief Number of parameters.
+		size_t options{ 0u };			///< @brief Number of options.
+		size_t flags{ 0u };				///< @brief Number of flags.
+		size_t captures{ 0u };			///< @brief Number of options & flags that captured the following argument.
+		size_t flag_clusters{ 0u };		///< @brief Number of arguments that were parsed as one or more flags, such as "-hv".
+		size_t negative_numbers{ 0u };	///< @brief Number of arguments that began with a delimiter, but were parsed as parameters because they are negative numbers.
+		size_t name_bytes{ 0u };		///< @brief Total length of every argument's name.
+		size_t capture_bytes{ 0u };		///< @brief Total length of every captured argument.
+		size_t heap_bytes{ 0u };		///< @brief Lower bound of the bytes allocated by names & captures that are too long for the small string buffer. Some standard libraries, such as MSVC's, round capacities up, so the real number may be higher.
+		size_t size{ 0u };				///< @brief Number of arguments in the container.
+		size_t capacity{ 0u };			///< @brief Capacity of the container.
+
+		/**
+		 * @brief Retrieve the number of arguments of a given type.
+		 * @param type	- Argument type.
+		 * @returns size_t
+		 */
+		[[nodiscard]] constexpr size_t count(const Type type) const noexcept
+		{
+			switch (type) {
+			case Type::PARAMETER:
+				return parameters;
+			case Type::OPTION:
+				return options;
+			case Type::FLAG:
+				return flags;
+			default:
+				return 0u;
+			}
+		}
+		/// @brief Retrieve the average number of flags in each flag cluster.	@returns double
+		[[nodiscard]] constexpr double average_cluster_length() const noexcept { return flag_clusters == 0u ? 0.0 : static_cast<double>(flags) / static_cast<double>(flag_clusters); }
+		/// @brief Retrieve a lower bound of the number of bytes used by the container & the strings that it owns.	@returns size_t
+		[[nodiscard]] constexpr size_t footprint_bytes() const noexcept { return capacity * sizeof(VariantArgument) + heap_bytes; }
+
+		/**
+		 * @brief Add the arguments in a range to the per-type counts & byte totals.
+		 * @param first	- Iterator to the first argument.
+		 * @param last	- Iterator to one past the last argument.
+		 */
+		void add(ContainerType::const_iterator first, const ContainerType::const_iterator& last) noexcept
+		{
+			// strings are constructed from views, so their capacity is at least their length; anything longer than the small string buffer is on the heap
+			static const size_t sso_capacity{ std::string{}.capacity() };
+			const auto heap{ [](const size_t length) { return length > sso_capacity ? length + 1u : 0u; } };
+			for (; first != last; ++first) {
+				const auto type{ first->type() };
+				if (type == Type::PARAMETER)
+					++parameters;
+				else if (type == Type::OPTION)
+					++options;
+				else if (type == Type::FLAG)
+					++flags;
+				const auto name{ first->name_view() };
+				name_bytes += name.size();
+				if (type != Type::FLAG)
+					heap_bytes += heap(name.size());
+				if (const auto& cap{ first->capture() }; cap.has_value()) {
+					++captures;
+					capture_bytes += cap->size();
+					heap_bytes += heap(cap->size());
+				}
+			}
+		}
+		/**
+		 * @brief Record the size & capacity of a container.
+		 * @param cont	- Argument container.
+		 */
+		void measure(const ContainerType& cont) noexcept
+		{
+			size = cont.size();
+			capacity = cont.capacity();
+		}
+	};
+
+	/**
+	 * @brief Parse a range of strings, appending the results to an existing container.
+	 *\n	  This is the implementation used by every other parseArgs overload, & accepts any random access iterator whose value type is convertible to std::string_view.
+	 * @param cont	- Container to append the parsed arguments to.
+	 * @param first	- Iterator to the first argument.
+	 * @param last	- Iterator to one past the last argument.
+	 * @param cfg	- Parser Config Instance.
+	 * @param stats	- Optional pointer to a ParseStats instance that receives a summary of the parsed arguments.
+	 * @param fingerprint	- Optional pointer to an ArgsFingerprint instance that each parsed argument is added to.
 	 */
-	inline ContainerType parseArgs(const std::vector<std::string>& args, const ParserConfig& cfg = {})
+	template<class Iter> requires std::random_access_iterator<Iter> && std::convertible_to<std::iter_value_t<Iter>, std::string_view>
+	inline void parseArgs(ContainerType& cont, Iter first, const Iter last, const ParserConfig& cfg = {}, ParseStats* stats = nullptr, ArgsFingerprint* fingerprint = nullptr)
 	{
-		ContainerType cont;
-		cont.reserve(args.size()); // reserve enough space for all arguments should no captures occur.
+		const auto initial_size{ cont.size() };
+		OPT_TRACE_PHASE(trace::phase::CLASSIFY);
+		OPT_TRACE_AGGREGATE(capture_phase, trace::phase::CAPTURE);
+		// check if the argument after it exists & can be captured by the given option or flag
+		const auto canCapture{ [&](const Iter& it, const auto& name) {
+			OPT_TRACE_INTERVAL(capture_phase);
+			if (it + 1u == last)
+				return false;
+			const std::string_view next{ *(it + 1u) };
+			return (next.empty() || !cfg.isDelim(next.front())) && cfg.allowCapture(name);
+		} };
+		// append an argument, & fingerprint it while it is still in cache instead of making a second pass over the container
+		const auto append{ [&](auto&& arg) {
+			cont.emplace_back(std::forward<decltype(arg)>(arg));
+			if (fingerprint != nullptr)
+				fingerprint->add(cont.back());
+		} };
 
-		for (auto it{ args.begin() }; it != args.end(); ++it) {
-			const auto dashCount{ cfg.countPrefix(*it) };
+		for (auto it{ first }; it != last; ++it) {
+			const std::string_view arg{ *it };
+			const auto dashCount{ cfg.countPrefix(arg) };
 			switch (dashCount) {
 			case 2u: { // Option
-				if (it + 1u != args.end()
-					&& cfg.allowCapture(*it)
-					&& !cfg.isDelim((it + 1u)->at(0u))
-				) { // capture next argument
-					std::string here{ it->substr(dashCount) };
-					cont.emplace_back(std::make_pair(here, *++it)); // opt with capture
+				if (canCapture(it, arg)) { // capture next argument
+					std::string here{ arg.substr(dashCount) };
+					append(std::make_pair(std::move(here), std::string{ std::string_view{ *++it } })); // opt with capture
 				}
 				else
-					cont.emplace_back(std::make_pair(it->substr(dashCount), std::nullopt)); // opt without capture
+					append(std::make_pair(std::string{ arg.substr(dashCount) }, std::nullopt)); // opt without capture
 				break;
 			}
 			case 1u: { // Flag
-				std::string arg{ *it };
+				const bool hex_prefix{ arg.substr(dashCount, 2ull) == "0x" };
 				// if not a negative number & not a negative hexadecimal number, parse as a flag
-				if (const bool hex_prefix{ arg.substr(dashCount, 2ull) == "0x" }; !hex_prefix && !std::all_of(arg.begin() + dashCount + (hex_prefix ? 2ull : 0ull), arg.end(), [](auto&& ch) { return isdigit(ch) || ch == '.'; })) {
+				if (!hex_prefix && !std::all_of(arg.begin() + dashCount + (hex_prefix ? 2ull : 0ull), arg.end(), [](auto&& ch) { return isdigit(ch) || ch == '.'; })) {
+					if (stats != nullptr)
+						++stats->flag_clusters;
+					// reserve space for the whole cluster at once, so that long clusters don't reallocate the container repeatedly
+					if (const auto required{ cont.size() + arg.size() - dashCount + static_cast<size_t>(std::distance(it, last)) - 1u }; required > cont.capacity())
+						cont.reserve(std::max(required, cont.capacity() * 2u));
 					for (auto ch{ arg.begin() + dashCount }; ch != arg.end(); ++ch) {
-						if (it + 1u < args.end()
-							&& cfg.allowCapture(*ch)
-							&& !cfg.isDelim((it + 1u)->at(0u))
-							)
-							cont.emplace_back(std::make_pair(*ch, *++it)); // flag with capture
+						if (canCapture(it, *ch))
+							append(std::make_pair(*ch, std::string{ std::string_view{ *++it } })); // flag with capture
 						else
-							cont.emplace_back(std::make_pair(*ch, std::nullopt)); // flag without capture
+							append(std::make_pair(*ch, std::nullopt)); // flag without capture
+						if (ch != arg.begin() + dashCount)
+							cont.back().set_continues_cluster(true);
 					}
 					break;
 				}
+				// a delimiter without any digits, such as "-", is still a parameter but isn't counted as a number
+				if (stats != nullptr && std::any_of(arg.begin() + dashCount + (hex_prefix ? 2ull : 0ull), arg.end(), [hex_prefix](auto&& ch) { return hex_prefix ? isxdigit(ch) : isdigit(ch); }))
+					++stats->negative_numbers;
 				[[fallthrough]]; // if arg was a negative number or negative hexadecimal number
 			}
 			case 0u: { // Parameter
-				cont.emplace_back(*it); // parameter
+				append(std::string{ arg }); // parameter
 				break;
 			}
 			default: // shouldn't be possible
 				break;
 			}
 		}
+		if (stats != nullptr) {
+			stats->add(cont.begin() + static_cast<ptrdiff_t>(initial_size), cont.end());
+			stats->measure(cont);
+		}
+	}
 
-		cont.shrink_to_fit(); // reduce capacity to fit, as some arguments may have been captured.
-		return cont;
+	namespace _internal {
+		/**
+		 * @brief Parse a vector of strings or string views into a new container, which is shrunk to fit afterwards.
+		 *\n	  This is the implementation of the vector overloads of parseArgs.
+		 */
+		template<class Range>
+		inline ContainerType parse_vector(const Range& args, const ParserConfig& cfg, ParseStats* stats, ArgsFingerprint* fingerprint)
+		{
+			OPT_INSTRUMENT_SCOPE(PARSE_ARGS);
+			ContainerType cont;
+			cont.reserve(args.size()); // reserve enough space for all arguments should no captures occur.
+			parseArgs(cont, args.begin(), args.end(), cfg, stats, fingerprint);
+			OPT_TRACE_PHASE(trace::phase::SHRINK);
+			cont.shrink_to_fit(); // reduce capacity to fit, as some arguments may have been captured.
+			if (stats != nullptr)
+				stats->measure(cont);
+			return cont;
+		}
 	}
-}
\ No newline at end of file
+
+	/**
+	 * @brief Parse a list of strings into a variant container type.
+	 * @param args	- argv as a vector
+	 * @param cfg	- Parser Config Instance.
+	 * @param stats	- Optional pointer to a ParseStats instance that receives a summary of the parsed arguments.
+	 * @param fingerprint	- Optional pointer to an ArgsFingerprint instance that each parsed argument is added to.
+	 * @returns ContainerType
+	 */
+	inline ContainerType parseArgs(const std::vector<std::string>& args, const ParserConfig& cfg = {}, ParseStats* stats = nullptr, ArgsFingerprint* fingerprint = nullptr)
+	{
+		return _internal::parse_vector(args, cfg, stats, fingerprint);
+	}
+
+	/**
+	 * @brief Parse a list of string views into a variant container type. This avoids constructing an intermediate std::string for each argument.
+	 * @param args	- argv as a vector of views
+	 * @param cfg	- Parser Config Instance.
+	 * @param stats	- Optional pointer to a ParseStats instance that receives a summary of the parsed arguments.
+	 * @param fingerprint	- Optional pointer to an ArgsFingerprint instance that each parsed argument is added to.
+	 * @returns ContainerType
+	 */
+	inline ContainerType parseArgs(const std::vector<std::string_view>& args, const ParserConfig& cfg = {}, ParseStats* stats = nullptr, ArgsFingerprint* fingerprint = nullptr)
+	{
+		return _internal::parse_vector(args, cfg, stats, fingerprint);
+	}
+}
+
+/**
+ * @brief Hash specialization for opt::ContainerType, which uses the order-sensitive opt::fingerprint().
+ */
+template<> struct std::hash<opt::ContainerType> {
+	size_t operator()(const opt::ContainerType& cont) const noexcept { return static_cast<size_t>(opt::fingerprint(cont.begin(), cont.end())); }
+};
\ No newline at end of file
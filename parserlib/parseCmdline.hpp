@@ -0,0 +1,160 @@
+/**
+ * @file parseCmdline.hpp
+ * @author radj307
+ * @brief Contains functions for parsing NUL-delimited commandline buffers, such as the contents of /proc/<pid>/cmdline, without copying them into intermediate strings.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <stdexcept>
+#include <ParamsView.hpp>
+
+namespace opt {
+	/**
+	 * @brief Split a NUL-delimited commandline buffer into views of each argument, appending them to a vector.
+	 *\n	  A trailing NUL is optional. An empty buffer (such as the cmdline of a kernel thread) produces no arguments.
+	 * @param buffer	- NUL-delimited commandline buffer.
+	 * @param out		- Vector to append the views to. The views refer to buffer.
+	 */
+	inline void split_cmdline(std::string_view buffer, std::vector<std::string_view>& out)
+	{
+		while (!buffer.empty()) {
+			const auto pos{ buffer.find('\0') };
+			out.emplace_back(buffer.substr(0u, pos));
+			if (pos == std::string_view::npos)
+				break;
+			buffer.remove_prefix(pos + 1u);
+		}
+	}
+	/**
+	 * @brief Split a NUL-delimited commandline buffer into views of each argument.
+	 * @param buffer	- NUL-delimited commandline buffer.
+	 * @returns std::vector<std::string_view>
+	 */
+	inline std::vector<std::string_view> split_cmdline(const std::string_view buffer)
+	{
+		std::vector<std::string_view> vec;
+		vec.reserve(static_cast<size_t>(std::count(buffer.begin(), buffer.end(), '\0')) + 1u);
+		split_cmdline(buffer, vec);
+		return vec;
+	}
+
+	/**
+	 * @brief Parse a NUL-delimited commandline buffer.
+	 * @param buffer	- NUL-delimited commandline buffer.
+	 * @param cfg		- Parser Config Instance.
+	 * @param skip_arg0	- When true, the first argument is treated as argv[0] & is not parsed.
+	 * @returns ContainerType
+	 */
+	inline ContainerType parseCmdline(const std::string_view buffer, const ParserConfig& cfg = {}, const bool skip_arg0 = true)
+	{
+		const auto args{ split_cmdline(buffer) };
+		ContainerType cont;
+		if (args.empty())
+			return cont;
+		cont.reserve(args.size());
+		parseArgs(cont, args.begin() + (skip_arg0 ? 1 : 0), args.end(), cfg);
+		cont.shrink_to_fit();
+		return cont;
+	}
+
+	/**
+	 * @class CmdlineBatch
+	 * @brief Parses many NUL-delimited commandline buffers into one shared argument container, & provides a ParamsView of each one.
+	 *\n	  The container, & all internal buffers, keep their capacity when clear() is called, so a batch can be reused for every scan without reallocating.
+	 *\n	  Views returned by operator[] are invalidated by add() & clear().
+	 */
+	class CmdlineBatch {
+		struct Entry {
+			size_t first;			///< @brief Index of the first argument in _args.
+			size_t last;			///< @brief Index of one past the last argument in _args.
+			size_t arg0_off;		///< @brief Offset of argv[0] in _arg0s.
+			size_t arg0_len;		///< @brief Length of argv[0].
+			bool has_arg0;			///< @brief When true, argv[0] was present.
+		};
+
+		ParserConfig _cfg;							///< @brief Config used to parse every commandline.
+		ContainerType _args;						///< @brief Arguments of every commandline in the batch.
+		std::string _arg0s;							///< @brief argv[0] of every commandline in the batch.
+		std::vector<Entry> _entries;				///< @brief One entry per commandline.
+		std::vector<std::string_view> _scratch;		///< @brief Reused buffer for splitting commandlines.
+
+	public:
+		/**
+		 * @brief Default Constructor.
+		 * @param cfg	- Parser Config Instance used for every commandline.
+		 */
+		explicit CmdlineBatch(ParserConfig cfg = {}) : _cfg{ std::move(cfg) } {}
+
+		/**
+		 * @brief Reserve space for a number of commandlines & arguments.
+		 * @param cmdlines	- Expected number of commandlines.
+		 * @param args		- Expected total number of arguments.
+		 */
+		void reserve(const size_t cmdlines, const size_t args)
+		{
+			_entries.reserve(cmdlines);
+			_args.reserve(args);
+		}
+
+		/**
+		 * @brief Parse a NUL-delimited commandline buffer & add it to the batch. The first argument is treated as argv[0].
+		 * @param buffer	- NUL-delimited commandline buffer. The batch does not keep any references to it.
+		 * @returns size_t	- The index of the commandline in the batch.
+		 */
+		size_t add(const std::string_view buffer)
+		{
+			_scratch.clear();
+			split_cmdline(buffer, _scratch);
+			Entry entry{ _args.size(), _args.size(), _arg0s.size(), 0u, !_scratch.empty() };
+			if (entry.has_arg0) {
+				_arg0s.append(_scratch.front());
+				entry.arg0_len = _scratch.front().size();
+				parseArgs(_args, _scratch.begin() + 1, _scratch.end(), _cfg);
+			}
+			entry.last = _args.size();
+			_entries.emplace_back(entry);
+			return _entries.size() - 1u;
+		}
+
+		[[nodiscard]] size_t size() const { return _entries.size(); }	///< @brief Retrieve the number of commandlines in the batch.	@returns size_t
+		[[nodiscard]] bool empty() const { return _entries.empty(); }	///< @brief Check if the batch is empty.						@returns bool
+		[[nodiscard]] const ContainerType& args() const { return _args; }	///< @brief Retrieve the arguments of every commandline.	@returns const ContainerType&
+
+		/**
+		 * @brief Retrieve a view of one commandline in the batch.
+		 * @param pos	- Index returned by add().
+		 * @returns ParamsView
+		 */
+		[[nodiscard]] ParamsView operator[](const size_t pos) const
+		{
+			const auto& entry{ _entries[pos] };
+			return{
+				_args.begin() + static_cast<ptrdiff_t>(entry.first),
+				_args.begin() + static_cast<ptrdiff_t>(entry.last),
+				entry.has_arg0 ? std::optional<std::string_view>{ std::string_view{ _arg0s }.substr(entry.arg0_off, entry.arg0_len) } : std::nullopt
+			};
+		}
+		/**
+		 * @brief Retrieve a view of one commandline in the batch.
+		 * @param pos	- Index returned by add().
+		 * @returns ParamsView
+		 * @throws std::out_of_range	- If pos is out of range.
+		 */
+		[[nodiscard]] ParamsView at(const size_t pos) const
+		{
+			if (pos >= _entries.size())
+				throw std::out_of_range("CmdlineBatch index out of range!");
+			return operator[](pos);
+		}
+
+		/**
+		 * @brief Remove every commandline from the batch, keeping the allocated capacity.
+		 */
+		void clear() noexcept
+		{
+			_args.clear();
+			_arg0s.clear();
+			_entries.clear();
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/**
+ * @file parseResponseFile.hpp
+ * @author radj307
+ * @brief Contains the parseResponseFile function, which parses arguments stored in a response file, with an optional on-disk cache of the parsed result.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+#include <mapped-file.hpp>
+#include <serialize-args.hpp>
+
+namespace opt {
+	inline constexpr std::string_view RESPONSE_CACHE_MAGIC{ "OPTRSPC1" };	///< @brief Identifies a response file cache, & its format version.
+	inline constexpr std::string_view RESPONSE_CACHE_EXTENSION{ ".optcache" };	///< @brief Appended to the response file's path to get the path of its cache.
+
+	/**
+	 * @struct ResponseCacheKey
+	 * @brief Identifies the inputs that a cached parse result was produced from. A cache is only used when all fields match.
+	 */
+	struct ResponseCacheKey {
+		uint64_t content_hash{ 0u };	///< @brief FNV-1a hash of the response file's contents.
+		int64_t mtime{ 0 };				///< @brief Last write time of the response file.
+		uint64_t config{ 0u };			///< @brief ParserConfig::fingerprint() of the config used to parse the file.
+
+		bool operator==(const ResponseCacheKey&) const = default;
+	};
+
+	/**
+	 * @brief Split the contents of a response file into arguments.
+	 *\n	  Arguments are separated by whitespace. Whitespace may be included in an argument by enclosing it in single or double quotes, which are removed.
+	 * @param contents	- Response file contents.
+	 * @returns std::vector<std::string>
+	 */
+	inline std::vector<std::string> tokenize_response(const std::string_view contents)
+	{
+		std::vector<std::string> vec;
+		std::string token;
+		bool in_token{ false };
+		char quote{ '\0' };
+		for (const auto& ch : contents) {
+			if (quote != '\0') {
+				if (ch == quote)
+					quote = '\0';
+				else
+					token.push_back(ch);
+			}
+			else if (ch == '"' || ch == '\'') {
+				quote = ch;
+				in_token = true;
+			}
+			else if (std::isspace(static_cast<unsigned char>(ch))) {
+				if (in_token)
+					vec.emplace_back(std::move(token));
+				token.clear();
+				in_token = false;
+			}
+			else {
+				token.push_back(ch);
+				in_token = true;
+			}
+		}
+		if (in_token)
+			vec.emplace_back(std::move(token));
+		return vec;
+	}
+
+	/**
+	 * @brief Attempt to load a cached parse result.
+	 * @param cache_path	- Path to the cache file.
+	 * @param key			- Expected cache key. If the cache was created with a different key, it is ignored.
+	 * @returns std::optional<ContainerType>
+	 *\n		std::nullopt	- The cache doesn't exist, is stale, or is corrupt.
+	 */
+	inline std::optional<ContainerType> load_response_cache(const std::filesystem::path& cache_path, const ResponseCacheKey& key)
+	{
+		const MappedFile file{ cache_path };
+		auto in{ file.view() };
+		if (!file.is_open() || in.size() < RESPONSE_CACHE_MAGIC.size() + sizeof(ResponseCacheKey) || in.substr(0u, RESPONSE_CACHE_MAGIC.size()) != RESPONSE_CACHE_MAGIC)
+			return std::nullopt;
+		in.remove_prefix(RESPONSE_CACHE_MAGIC.size());
+		ResponseCacheKey cached;
+		std::memcpy(&cached, in.data(), sizeof(ResponseCacheKey));
+		in.remove_prefix(sizeof(ResponseCacheKey));
+		if (cached != key)
+			return std::nullopt;
+		return deserialize(in);
+	}
+
+	/**
+	 * @brief Write a parse result to a cache file. The file is replaced with write_file_atomic(), so concurrent readers never see a partial cache.
+	 * @param cache_path	- Path to the cache file.
+	 * @param key			- Cache key that the result was produced from.
+	 * @param cont			- Parsed arguments.
+	 * @returns bool
+	 *\n		true	- The cache was written.
+	 *\n		false	- The cache could not be written. This is not an error, the next run will simply parse the file again.
+	 */
+	inline bool save_response_cache(const std::filesystem::path& cache_path, const ResponseCacheKey& key, const ContainerType& cont)
+	{
+		std::string buffer{ RESPONSE_CACHE_MAGIC };
+		buffer.append(reinterpret_cast<const char*>(&key), sizeof(ResponseCacheKey));
+		serialize(buffer, cont.begin(), cont.end());
+
+		return write_file_atomic(cache_path, buffer);
+	}
+
+	/**
+	 * @brief Parse the arguments stored in a response file.
+	 *\n	  When use_cache is true, the parsed result is stored next to the response file (see RESPONSE_CACHE_EXTENSION), & subsequent calls with the same
+	 *\n	  file contents, modification time & ParserConfig load the cached result instead of tokenizing & parsing the file again.
+	 *\n	  Any mismatch or corruption falls back to a normal parse.
+	 * @param path		- Path to the response file.
+	 * @param cfg		- Parser Config Instance.
+	 * @param use_cache	- When true, the on-disk cache is used & updated.
+	 * @returns ContainerType
+	 * @throws std::runtime_error	- If the response file could not be opened.
+	 */
+	inline ContainerType parseResponseFile(const std::filesystem::path& path, const ParserConfig& cfg = {}, const bool use_cache = false)
+	{
+		const MappedFile file{ path };
+		if (!file.is_open())
+			throw std::runtime_error("Failed to open response file!");
+		if (!use_cache)
+			return parseArgs(tokenize_response(file.view()), cfg);
+
+		std::error_code ec;
+		const ResponseCacheKey key{
+			fnv1a(file.view()),
+			static_cast<int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count()),
+			cfg.fingerprint()
+		};
+		auto cache_path{ path };
+		cache_path += RESPONSE_CACHE_EXTENSION;
+
+		if (auto cached{ load_response_cache(cache_path, key) }; cached.has_value())
+			return std::move(cached.value());
+
+		auto cont{ parseArgs(tokenize_response(file.view()), cfg) };
+		save_response_cache(cache_path, key, cont);
+		return cont;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+/**
+ * @file render-argv.hpp
+ * @author radj307
+ * @brief Contains functions that render parsed arguments back into an argv array, for re-executing the program or forwarding arguments to a child process.
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <CStringArray.hpp>
+#include <ParamsView.hpp>
+#include <cctype>
+#include <stdexcept>
+#include <vector>
+
+namespace opt {
+	/**
+	 * @brief Render a range of parsed arguments back into an argv array, in a single allocation.
+	 *\n	  Parsing the unfiltered output with the same ParserConfig produces the same arguments:
+	 *\n	  - Options are written as "--name", followed by their capture.
+	 *\n	  - Flags are written in the clusters they were parsed from, such as "-ab -c", followed by the captures of each flag in the cluster.
+	 *\n	    Flags that weren't produced by parseArgs are written as separate clusters.
+	 *\n	  - Parameters are written as-is.
+	 *\n	  When filtering leaves a cluster that would be parsed as a negative number or an option, such as "-1", "-0x" or "--", it is joined to a neighbouring cluster.
+	 *\n	  Note that filtering out an argument can place a capturing option or flag that had no capture directly before a parameter, which it would capture when reparsed.
+	 * @param out		- Block to write to. Its existing allocation is reused when it is large enough.
+	 * @param args		- Arguments to render.
+	 * @param filter	- Predicate that accepts a const VariantArgument& & returns true for each argument that should be rendered.
+	 * @param arg0		- When this has a value, it is written as the first argument.
+	 * @param prefix	- The delimiter character used for options & flags.
+	 * @returns char**	- The NULL-terminated argv array, which is valid for as long as out is alive & unmodified.
+	 * @throws std::runtime_error	- If a run of consecutive flags can only be written as a negative number or an option, such as "-12".
+	 */
+	template<class Pred> requires std::predicate<Pred&, const VariantArgument&>
+	inline char** render_argv(CStringArray& out, const ParamsView& args, Pred&& filter, const std::optional<std::string_view>& arg0 = std::nullopt, const char prefix = _DEFAULT_OPT_DELIMITERS.front())
+	{
+		struct Item {
+			const VariantArgument* arg;
+			bool new_cluster; ///< @brief When true, this flag is written at the start of a new cluster.
+		};
+		std::vector<Item> items;
+		items.reserve(args.size());
+		bool cluster_kept{ false }; // true when a flag from the current cluster has been kept
+		for (const auto& arg : args) {
+			if (!arg.continues_cluster())
+				cluster_kept = false;
+			if (filter(arg)) {
+				items.push_back({ &arg, !cluster_kept });
+				cluster_kept = arg.type() == Type::FLAG;
+			}
+		}
+
+		// parseArgs reads "-<cluster>" as a parameter when the cluster is a number or hexadecimal number, & as an option when it begins with the prefix
+		const auto misparsed{ [&items, prefix](const size_t first, const size_t last) {
+			const auto ch{ [&items](const size_t i) { return items[i].arg->name_view().front(); } };
+			if (ch(first) == prefix || (last - first >= 2u && ch(first) == '0' && ch(first + 1u) == 'x'))
+				return true;
+			for (size_t i{ first }; i < last; ++i)
+				if (!std::isdigit(static_cast<unsigned char>(ch(i))) && ch(i) != '.')
+					return false;
+			return true;
+		} };
+		for (size_t i{ 0u }; i < items.size(); ) {
+			if (items[i].arg->type() != Type::FLAG) {
+				++i;
+				continue;
+			}
+			size_t run_end{ i + 1u };
+			while (run_end < items.size() && items[run_end].arg->type() == Type::FLAG)
+				++run_end;
+			// join each cluster that would be misparsed to its neighbours within this run of consecutive flags
+			size_t cluster{ i };
+			for (size_t next{ i + 1u }; next < run_end; ++next) {
+				if (!items[next].new_cluster)
+					continue;
+				size_t next_end{ next + 1u };
+				while (next_end < run_end && !items[next_end].new_cluster)
+					++next_end;
+				if (misparsed(cluster, next) || misparsed(next, next_end))
+					items[next].new_cluster = false;
+				else
+					cluster = next;
+			}
+			if (misparsed(cluster, run_end))
+				throw std::runtime_error("render_argv() failed:  The remaining flags would be parsed as a negative number or an option!");
+			i = run_end;
+		}
+
+		out.assign_with([&](auto& sink) {
+			if (arg0.has_value()) {
+				sink.append(arg0.value());
+				sink.end_string();
+			}
+			size_t cluster{ items.size() }; // index of the first flag in the current cluster, or items.size() when there isn't one
+			const auto end_cluster{ [&sink, &items, &cluster](const size_t last) {
+				if (cluster == items.size())
+					return;
+				sink.end_string();
+				for (size_t i{ cluster }; i < last; ++i) {
+					if (const auto& capture{ items[i].arg->capture() }; capture.has_value()) {
+						sink.append(capture.value());
+						sink.end_string();
+					}
+				}
+				cluster = items.size();
+			} };
+			for (size_t i{ 0u }; i < items.size(); ++i) {
+				const auto& arg{ *items[i].arg };
+				switch (arg.type()) {
+				case Type::FLAG:
+					if (items[i].new_cluster) {
+						end_cluster(i);
+						sink.append(prefix);
+						cluster = i;
+					}
+					sink.append(arg.name_view());
+					break;
+				case Type::OPTION:
+					end_cluster(i);
+					sink.append(prefix);
+					sink.append(prefix);
+					sink.append(arg.name_view());
+					sink.end_string();
+					if (const auto& capture{ arg.capture() }; capture.has_value()) {
+						sink.append(capture.value());
+						sink.end_string();
+					}
+					break;
+				case Type::PARAMETER:
+					end_cluster(i);
+					sink.append(arg.name_view());
+					sink.end_string();
+					break;
+				default:
+					break;
+				}
+			}
+			end_cluster(items.size());
+		});
+		return out.data();
+	}
+	/**
+	 * @brief Render a range of parsed arguments back into an argv array, in a single allocation.
+	 * @param out		- Block to write to. Its existing allocation is reused when it is large enough.
+	 * @param args		- Arguments to render.
+	 * @param arg0		- When this has a value, it is written as the first argument.
+	 * @returns char**	- The NULL-terminated argv array, which is valid for as long as out is alive & unmodified.
+	 */
+	inline char** render_argv(CStringArray& out, const ParamsView& args, const std::optional<std::string_view>& arg0 = std::nullopt)
+	{
+		return render_argv(out, args, [](const VariantArgument&) { return true; }, arg0);
+	}
+	/**
+	 * @brief Render a range of parsed arguments back into a new argv array.
+	 * @param args		- Arguments to render.
+	 * @param filter	- Predicate that accepts a const VariantArgument& & returns true for each argument that should be rendered.
+	 * @param arg0		- When this has a value, it is written as the first argument.
+	 * @returns CStringArray
+	 */
+	template<class Pred> requires std::predicate<Pred&, const VariantArgument&>
+	inline CStringArray render_argv(const ParamsView& args, Pred&& filter, const std::optional<std::string_view>& arg0 = std::nullopt)
+	{
+		CStringArray out;
+		render_argv(out, args, std::forward<Pred>(filter), arg0);
+		return out;
+	}
+}
\ No newline at end of file
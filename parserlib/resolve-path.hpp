@@ -7,6 +7,16 @@
 #include <OPT_PARSER_LIB.h>
 #include <file.h>		///< @brief Requires file.h from sharedlib!
 #include <optenv.hpp>
+#include <EnvView.hpp>
+#include <mapped-file.hpp>
+#include <opthash.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <unordered_set>
+#ifdef __linux__
+#include <unistd.h>
+#endif
 #ifdef SHARED_LIB
 
 namespace opt {
@@ -54,8 +64,181 @@ namespace opt {
 		return { {}, arg }; // return not found
 	}
 
+	inline constexpr size_t RESOLVE_CACHE_MAX_ENTRIES{ 256u }; ///< @brief The maximum number of entries kept in a path resolution cache. When exceeded, the oldest entries are discarded.
+
+	/**
+	 * @function default_resolve_cache_path()
+	 * @brief Retrieve the default location of the path resolution cache used by resolve_split_path_cached.
+	 *\n	  This is $XDG_CACHE_HOME/opt-resolve-path.cache, falling back to $HOME/.cache/ & then the system's temporary directory.
+	 * @returns std::filesystem::path
+	 */
+	inline std::filesystem::path default_resolve_cache_path()
+	{
+		constexpr auto filename{ "opt-resolve-path.cache" };
+		if (const char* xdg{ std::getenv("XDG_CACHE_HOME") }; xdg != nullptr && *xdg != '\0')
+			return std::filesystem::path{ xdg } / filename;
+		if (const char* home{ std::getenv("HOME") }; home != nullptr && *home != '\0')
+			return std::filesystem::path{ home } / ".cache" / filename;
+		std::error_code ec;
+		return std::filesystem::temp_directory_path(ec) / filename;
+	}
+
+	/**
+	 * @function resolve_split_path_cached(const std::vector<std::string>&, const std::string&, const std::filesystem::path&, const std::vector<std::string>&, const char)
+	 * @brief Cached version of resolve_split_path. Results are stored in an on-disk cache keyed by the contents of PATH, arg & extensions.
+	 *\n	  A cache hit is validated with a single stat of the resolved file & skips the PATH walk entirely. Results that weren't found are not cached.
+	 *\n	  Note that a hit is not invalidated when an executable with the same name is added to an earlier PATH directory.
+	 * @param PATH			- Contents of the PATH environment variable. Can be retrieve from opt::Environment::getPath()
+	 * @param arg			- argv[0] from main() or another path to resolve.
+	 * @param cache_path	- Location of the cache file. See default_resolve_cache_path().
+	 * @param extensions	- A list of possible file extensions to append to arg before giving up on a directory.
+	 * @param pathDelim		- Delimiter used to separate paths. ( '/' on UNIX, '\' on Windows )
+	 * @returns std::pair<std::string, std::string>
+	 *\n		first		- The path to the directory where this program is located, including a trailing slash.
+	 *\n		second		- The name used to call this program.
+	 */
+	inline std::pair<std::string, std::string> resolve_split_path_cached(const std::vector<std::string>& PATH, const std::string& arg, const std::filesystem::path& cache_path = default_resolve_cache_path(), const std::vector<std::string>& extensions = { ".exe", ".bat", ".so" }, const char pathDelim = '/')
+	{
+		if (const auto [path, name] { split_path(arg) }; !path.empty() && !str::pos_valid(path.find('.')))
+			return{ path, name }; // absolute paths don't need to be resolved
+
+		uint64_t hash{ FNV_OFFSET_BASIS };
+		for (auto& it : PATH)
+			hash = fnv1a(std::string_view{ it.c_str(), it.size() + 1u }, hash); // include the null terminator as a separator
+		hash = fnv1a(std::string_view{ arg.c_str(), arg.size() + 1u }, hash);
+		for (auto& ext : extensions)
+			hash = fnv1a(std::string_view{ ext.c_str(), ext.size() + 1u }, hash);
+		hash = fnv1a(pathDelim, hash);
+		char key[17]{};
+		std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+
+		// each line in the cache is formatted as "<key>\t<directory>\t<name>"
+		std::vector<std::string_view> lines;
+		const MappedFile cache{ cache_path };
+		for (auto contents{ cache.view() }; !contents.empty(); ) {
+			const auto eol{ contents.find('\n') };
+			if (const auto ln{ contents.substr(0u, eol) }; ln.size() > 17u && ln.substr(0u, 16u) != key)
+				lines.emplace_back(ln);
+			else if (const auto sep{ ln.find('\t', 17u) }; ln.size() > 17u && str::pos_valid(sep)) {
+				std::pair<std::string, std::string> result{ ln.substr(17u, sep - 17u), ln.substr(sep + 1u) };
+				std::error_code ec;
+				if (std::filesystem::is_regular_file(result.first + result.second, ec))
+					return result;
+			}
+			if (eol == std::string_view::npos)
+				break;
+			contents.remove_prefix(eol + 1u);
+		}
+
+		auto result{ resolve_split_path(PATH, arg, extensions, pathDelim) };
+		if (result.first.empty() || str::pos_valid(result.first.find_first_of("\t\n")) || str::pos_valid(result.second.find_first_of("\t\n")))
+			return result;
+
+		// rewrite the cache with the new entry appended, discarding the oldest entries if it is full
+		std::string buffer;
+		for (auto it{ lines.size() >= RESOLVE_CACHE_MAX_ENTRIES ? lines.end() - (RESOLVE_CACHE_MAX_ENTRIES - 1u) : lines.begin() }; it != lines.end(); ++it)
+			(buffer += *it) += '\n';
+		(((buffer += key) += '\t') += result.first) += '\t';
+		(buffer += result.second) += '\n';
+
+		std::error_code ec;
+		std::filesystem::create_directories(cache_path.parent_path(), ec);
+		write_file_atomic(cache_path, buffer);
+		return result;
+	}
+
+	/**
+	 * @struct DirectoryListing
+	 * @brief Hashed set of the names of every entry in a directory, which supports lookups by std::string_view.
+	 */
+	struct DirectoryListing {
+		struct hash : std::hash<std::string_view> { using is_transparent = void; };
+		std::unordered_set<std::string, hash, std::equal_to<>> names;
+
+		/**
+		 * @brief Read the names of every entry in a directory. Directories that cannot be read produce an empty listing.
+		 * @param dir	- Target directory.
+		 */
+		explicit DirectoryListing(const std::filesystem::path& dir)
+		{
+			std::error_code ec;
+			for (std::filesystem::directory_iterator it{ dir, std::filesystem::directory_options::skip_permission_denied, ec }, end; !ec && it != end; it.increment(ec))
+				names.emplace(it->path().filename().string());
+		}
+
+		[[nodiscard]] bool contains(const std::string_view name) const { return names.find(name) != names.end(); } ///< @brief Check if the directory contains an entry with the given name. @returns bool
+	};
+
 	/**
-	 * @function resolve_split_path(const std::vector<std::string>&, const std::string&)
+	 * @function resolve_split_paths(const std::vector<std::string>&, const std::vector<std::string>&, const std::vector<std::string>&, const bool, const char)
+	 * @brief Resolve the locations of many names at once, like calling resolve_split_path for each one.
+	 *\n	  Each directory in PATH is listed exactly once, & every name + extension combination is resolved against the hashed listings,
+	 *\n	  so the cost is one directory scan per PATH entry instead of one stat per name, extension & PATH entry.
+	 * @param PATH			- Contents of the PATH environment variable. Can be retrieve from opt::Environment::getPath()
+	 * @param names			- Names to resolve.
+	 * @param extensions	- A list of possible file extensions to append to each name before giving up on a directory.
+	 * @param parallel		- When true, each directory is listed on its own thread.
+	 * @param pathDelim		- Delimiter used to separate paths. ( '/' on UNIX, '\' on Windows )
+	 * @returns std::vector<std::pair<std::string, std::string>>	- One result per name, in the same order. See resolve_split_path.
+	 */
+	inline std::vector<std::pair<std::string, std::string>> resolve_split_paths(const std::vector<std::string>& PATH, const std::vector<std::string>& names, const std::vector<std::string>& extensions = { ".exe", ".bat", ".so" }, const bool parallel = false, const char pathDelim = '/')
+	{
+		OPT_TRACE_PHASE(trace::phase::PATH);
+		std::vector<DirectoryListing> listings;
+		listings.reserve(PATH.size());
+		if (parallel) {
+			std::vector<std::future<DirectoryListing>> futures;
+			futures.reserve(PATH.size());
+			for (auto& it : PATH)
+				futures.emplace_back(std::async(std::launch::async, [&it]() { return DirectoryListing{ it }; }));
+			for (auto& it : futures)
+				listings.emplace_back(it.get());
+		}
+		else for (auto& it : PATH)
+			listings.emplace_back(it);
+
+		std::vector<std::pair<std::string, std::string>> results;
+		results.reserve(names.size());
+		std::string candidate;
+		for (auto& arg : names) {
+			if (const auto [path, name] { split_path(arg) }; !path.empty() || name.empty()) { // names containing a path, & empty names (which match the directory itself), can't be matched against a listing
+				results.emplace_back(resolve_split_path(PATH, arg, extensions, pathDelim));
+				continue;
+			}
+			const auto found{ [&]() -> std::pair<std::string, std::string> {
+				for (size_t i{ 0u }; i < PATH.size(); ++i) {
+					if (listings[i].contains(arg))
+						return{ PATH[i] + pathDelim, arg };
+					for (auto& ext : extensions)
+						if (listings[i].contains((candidate = arg) += ext))
+							return{ PATH[i] + pathDelim, candidate };
+				}
+				return{ {}, arg }; // not found
+			}() };
+			results.emplace_back(found);
+		}
+		return results;
+	}
+
+	/**
+	 * @function path_list(const EnvView&)
+	 * @brief Copy the elements of the PATH variable into a vector, using the platform's list separator. Empty elements are skipped.
+	 * @param env	- The environment to read PATH from.
+	 * @returns std::vector<std::string>	- This is empty if the PATH variable doesn't exist.
+	 */
+	inline std::vector<std::string> path_list(const EnvView& env)
+	{
+		const auto PATH{ env.PATH() };
+		std::vector<std::string> vec;
+		vec.reserve(PATH.size());
+		for (const auto& dir : PATH)
+			if (!dir.empty())
+				vec.emplace_back(dir);
+		return vec;
+	}
+
+	/**
+	 * @function resolve_split_path(char**, const std::string&)
 	 * @brief Parse the user's PATH environment variable to find the location of argv[0]
 	 * @param envp	- envp[] from main()
 	 * @param arg	- argv[0] from main()
@@ -65,7 +248,7 @@ namespace opt {
 	 */
 	inline std::pair<std::string, std::string> resolve_split_path(char** envp, const std::string& arg)
 	{
-		return resolve_split_path(Env{ envp }.PATH(), arg);
+		return resolve_split_path(path_list(EnvView{ envp }), arg);
 	}
 
 	/**
@@ -78,9 +261,155 @@ namespace opt {
 	 */
 	template<class T> static std::string resolve_path(T&& env, const std::string& arg)
 	{
+		OPT_INSTRUMENT_SCOPE(RESOLVE_PATH);
+		OPT_TRACE_PHASE(trace::phase::PATH);
 		const auto [path, name] { resolve_split_path(std::forward<T>(env), arg) };
 		return path + name;
 	}
+
+	/**
+	 * @brief Identifies the source that was used to resolve the location of the running executable.
+	 */
+	enum class ResolveStrategy : unsigned char {
+		NONE = 0u,				///< @brief The location could not be resolved.
+		SELF_EXE = 1u,			///< @brief The location was read from /proc/self/exe.
+		ABSOLUTE_ARGV0 = 2u,	///< @brief argv[0] already contained the path to the executable.
+		PATH_SCAN = 3u,			///< @brief The location was found by searching each directory in PATH.
+	};
+
+	/**
+	 * @brief Returns a ResolveStrategy as plaintext.
+	 * @param strategy	- Strategy to convert.
+	 * @returns std::string
+	 */
+	inline std::string get_strategyname(const ResolveStrategy& strategy)
+	{
+		using enum ResolveStrategy;
+		switch (strategy) {
+		case SELF_EXE:
+			return "SELF_EXE";
+		case ABSOLUTE_ARGV0:
+			return "ABSOLUTE_ARGV0";
+		case PATH_SCAN:
+			return "PATH_SCAN";
+		default:
+			return "NONE";
+		}
+	}
+
+	/**
+	 * @struct ResolvedPath
+	 * @brief The result of resolve_executable, which includes the strategy that produced it.
+	 */
+	struct ResolvedPath {
+		std::string path;			///< @brief The path to the directory where the program is located, including a trailing slash.
+		std::string name;			///< @brief The name of the program.
+		ResolveStrategy strategy;	///< @brief The strategy that produced this result.
+
+		/// @brief Check if the location was resolved.
+		explicit operator bool() const { return strategy != ResolveStrategy::NONE; }
+		/// @brief Retrieve the full path to the program. This is the same value returned by resolve_path.
+		operator std::string() const { return path + name; }
+	};
+
+	/**
+	 * @function self_exe_path()
+	 * @brief Retrieve the path to the running executable from the operating system, with a single syscall.
+	 *\n	  This is only supported on Linux (/proc/self/exe), & returns std::nullopt on other platforms, when /proc is not mounted, or when the executable was deleted.
+	 * @returns std::optional<std::string>
+	 */
+	inline std::optional<std::string> self_exe_path()
+	{
+	#ifdef __linux__
+		std::string buffer(256u, '\0');
+		for (;;) {
+			const auto len{ readlink("/proc/self/exe", buffer.data(), buffer.size()) };
+			if (len <= 0)
+				return std::nullopt;
+			if (static_cast<size_t>(len) < buffer.size()) {
+				buffer.resize(static_cast<size_t>(len));
+				break;
+			}
+			buffer.resize(buffer.size() * 2u); // the path may have been truncated, try again with a larger buffer
+		}
+		if (constexpr std::string_view deleted{ " (deleted)" }; buffer.size() > deleted.size() && std::string_view{ buffer }.substr(buffer.size() - deleted.size()) == deleted)
+			return std::nullopt;
+		return buffer;
+	#else
+		return std::nullopt;
+	#endif
+	}
+
+	/**
+	 * @function resolve_executable_without_path(const std::string&)
+	 * @brief Attempt to resolve the location of the running executable using only the strategies that don't require PATH. (SELF_EXE & ABSOLUTE_ARGV0)
+	 * @param arg	- argv[0] from main().
+	 * @returns std::optional<ResolvedPath>
+	 */
+	inline std::optional<ResolvedPath> resolve_executable_without_path(const std::string& arg)
+	{
+		using enum ResolveStrategy;
+		if (const auto exe{ self_exe_path() }; exe.has_value()) {
+			auto [path, name] { split_path(exe.value()) };
+			return ResolvedPath{ std::move(path), std::move(name), SELF_EXE };
+		}
+		if (auto [path, name] { split_path(arg) }; !path.empty() && !str::pos_valid(path.find('.')))
+			return ResolvedPath{ std::move(path), std::move(name), ABSOLUTE_ARGV0 };
+		return std::nullopt;
+	}
+
+	/**
+	 * @function resolve_executable_in_path(const std::vector<std::string>&, const std::string&, const std::vector<std::string>&, const char)
+	 * @brief Resolve the location of the running executable using only the PATH_SCAN strategy.
+	 *\n	  This is the fallback used by resolve_executable once resolve_executable_without_path has failed.
+	 * @param PATH			- Contents of the PATH environment variable.
+	 * @param arg			- argv[0] from main().
+	 * @param extensions	- A list of possible file extensions to append to arg before giving up on a directory.
+	 * @param pathDelim		- Delimiter used to separate paths. ( '/' on UNIX, '\' on Windows )
+	 * @returns ResolvedPath	- The strategy is NONE if arg wasn't found in any directory.
+	 */
+	inline ResolvedPath resolve_executable_in_path(const std::vector<std::string>& PATH, const std::string& arg, const std::vector<std::string>& extensions = { ".exe", ".bat", ".so" }, const char pathDelim = '/')
+	{
+		auto [path, name] { resolve_split_path(PATH, arg, extensions, pathDelim) };
+		const auto strategy{ path.empty() ? ResolveStrategy::NONE : ResolveStrategy::PATH_SCAN };
+		return{ std::move(path), std::move(name), strategy };
+	}
+
+	/**
+	 * @function resolve_executable(const std::vector<std::string>&, const std::string&, const std::vector<std::string>&, const char)
+	 * @brief Resolve the location of the running executable, using the cheapest reliable source available:
+	 *\n	  1. /proc/self/exe (Linux only). This resolves symlinks, so the name may differ from argv[0].
+	 *\n	  2. argv[0], if it already contains a path.
+	 *\n	  3. A scan of each directory in PATH, using resolve_split_path.
+	 *\n	  Use resolve_split_path directly when resolving a name other than this process's argv[0].
+	 * @param PATH			- Contents of the PATH environment variable. Only used by the PATH_SCAN strategy.
+	 * @param arg			- argv[0] from main().
+	 * @param extensions	- A list of possible file extensions to append to arg before giving up on a directory.
+	 * @param pathDelim		- Delimiter used to separate paths. ( '/' on UNIX, '\' on Windows )
+	 * @returns ResolvedPath
+	 */
+	inline ResolvedPath resolve_executable(const std::vector<std::string>& PATH, const std::string& arg, const std::vector<std::string>& extensions = { ".exe", ".bat", ".so" }, const char pathDelim = '/')
+	{
+		OPT_TRACE_PHASE(trace::phase::PATH);
+		if (auto result{ resolve_executable_without_path(arg) }; result.has_value())
+			return std::move(result.value());
+		return resolve_executable_in_path(PATH, arg, extensions, pathDelim);
+	}
+
+	/**
+	 * @function resolve_executable(char**, const std::string&)
+	 * @brief Resolve the location of the running executable, using the cheapest reliable source available.
+	 *\n	  The environment is only indexed if the PATH_SCAN strategy is required.
+	 * @param envp	- envp[] from main()
+	 * @param arg	- argv[0] from main()
+	 * @returns ResolvedPath
+	 */
+	inline ResolvedPath resolve_executable(char** envp, const std::string& arg)
+	{
+		if (auto result{ resolve_executable_without_path(arg) }; result.has_value())
+			return std::move(result.value());
+		return resolve_executable_in_path(path_list(EnvView{ envp }), arg);
+	}
 }
 #else
 #error resolve-path.hpp requires the shared library!
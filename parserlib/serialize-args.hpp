@@ -0,0 +1,296 @@
+/**
+ * @file serialize-args.hpp
+ * @author radj307
+ * @brief Contains functions for converting a ContainerType to & from a compact binary representation, & for writing it as JSON.
+ *\n	  Every writer accepts either a std::string or a BufferWriter, which writes directly into a caller-provided buffer without allocating.
+ */
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <parseArgs.hpp>
+#include <buffer-writer.hpp>
+
+namespace opt {
+	/**
+	 * @brief Append an unsigned LEB128-encoded integer to a buffer.
+	 * @param out	- Output buffer.
+	 * @param value	- Value to encode.
+	 */
+	template<class Out>
+	inline void write_varint(Out& out, uint64_t value)
+	{
+		for (; value >= 0x80u; value >>= 7u)
+			out.push_back(static_cast<char>((value & 0x7Fu) | 0x80u));
+		out.push_back(static_cast<char>(value));
+	}
+	/**
+	 * @brief Read an unsigned LEB128-encoded integer from the front of a buffer, removing it on success.
+	 * @param in	- Input buffer.
+	 * @returns std::optional<uint64_t>
+	 *\n		std::nullopt	- The buffer was truncated or malformed.
+	 */
+	inline std::optional<uint64_t> read_varint(std::string_view& in)
+	{
+		uint64_t value{ 0u };
+		for (unsigned shift{ 0u }; !in.empty() && shift < 64u; shift += 7u) {
+			const auto byte{ static_cast<unsigned char>(in.front()) };
+			in.remove_prefix(1u);
+			value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+			if ((byte & 0x80u) == 0u)
+				return value;
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Append a binary representation of a range of arguments to a buffer.
+	 *\n	  Layout: varint count, then for each argument a tag byte (Type | has_capture << 2), a varint name length & the name, and the same for the capture if present.
+	 * @param out	- Output buffer.
+	 * @param first	- Iterator to the first argument.
+	 * @param last	- Iterator to one past the last argument.
+	 */
+	template<class Out>
+	inline void serialize(Out& out, ContainerType::const_iterator first, const ContainerType::const_iterator& last)
+	{
+		write_varint(out, static_cast<uint64_t>(last - first));
+		for (; first != last; ++first) {
+			const auto& cap{ first->capture() };
+			out.push_back(static_cast<char>(static_cast<unsigned>(first->type()) | (cap.has_value() ? 0x4u : 0x0u)));
+			const auto name{ first->name_view() };
+			write_varint(out, name.size());
+			out.append(name);
+			if (cap.has_value()) {
+				write_varint(out, cap->size());
+				out.append(cap.value());
+			}
+		}
+	}
+	/**
+	 * @brief Retrieve a binary representation of an argument container.
+	 * @param cont	- Argument container.
+	 * @returns std::string
+	 */
+	inline std::string serialize(const ContainerType& cont)
+	{
+		std::string out;
+		serialize(out, cont.begin(), cont.end());
+		return out;
+	}
+
+	/**
+	 * @brief Write a binary representation of an argument container directly into a caller-provided buffer.
+	 * @param buffer	- Output buffer.
+	 * @param size		- Size of the output buffer.
+	 * @param cont		- Argument container.
+	 * @returns size_t	- The number of bytes required. If this is greater than size, the output was truncated & should be written again into a larger buffer.
+	 */
+	inline size_t serialize(char* buffer, const size_t size, const ContainerType& cont)
+	{
+		BufferWriter out{ buffer, size };
+		serialize(out, cont.begin(), cont.end());
+		return out.size();
+	}
+
+	/**
+	 * @brief Retrieve the length of the well-formed UTF-8 sequence at the start of a string.
+	 *\n	  Overlong encodings, surrogates & code points past U+10FFFF are not well-formed.
+	 * @param str	- A non-empty string.
+	 * @returns size_t	- The length of the sequence in bytes, or 0 if it isn't well-formed.
+	 */
+	inline size_t utf8_sequence_length(const std::string_view str) noexcept
+	{
+		const auto byte{ [&str](const size_t i) { return static_cast<unsigned char>(str[i]); } };
+		const auto lead{ byte(0u) };
+		size_t len;
+		unsigned char lo{ 0x80u }, hi{ 0xBFu }; // range of the second byte
+		if (lead < 0x80u)
+			return 1u;
+		else if (lead >= 0xC2u && lead <= 0xDFu)
+			len = 2u;
+		else if (lead >= 0xE0u && lead <= 0xEFu) {
+			len = 3u;
+			if (lead == 0xE0u)
+				lo = 0xA0u;
+			else if (lead == 0xEDu)
+				hi = 0x9Fu;
+		}
+		else if (lead >= 0xF0u && lead <= 0xF4u) {
+			len = 4u;
+			if (lead == 0xF0u)
+				lo = 0x90u;
+			else if (lead == 0xF4u)
+				hi = 0x8Fu;
+		}
+		else return 0u;
+		if (str.size() < len || byte(1u) < lo || byte(1u) > hi)
+			return 0u;
+		for (size_t i{ 2u }; i < len; ++i)
+			if (byte(i) < 0x80u || byte(i) > 0xBFu)
+				return 0u;
+		return len;
+	}
+
+	/**
+	 * @brief Append a string to a buffer as a quoted JSON string, escaping quotes, backslashes & control characters.
+	 *\n	  Bytes that aren't part of a well-formed UTF-8 sequence are replaced with \\ufffd, so the output is always valid JSON.
+	 * @param out	- Output buffer.
+	 * @param str	- String to write.
+	 */
+	template<class Out>
+	inline void write_json_string(Out& out, const std::string_view str)
+	{
+		constexpr char hex[]{ "0123456789abcdef" };
+		out.push_back('"');
+		auto run{ str.begin() }; // start of the characters that don't need to be escaped
+		for (auto it{ str.begin() }; it != str.end(); ++it) {
+			const auto ch{ static_cast<unsigned char>(*it) };
+			if (ch >= 0x80u) {
+				if (const auto len{ utf8_sequence_length(std::string_view{ it, str.end() }) }; len != 0u) {
+					it += static_cast<ptrdiff_t>(len - 1u);
+					continue;
+				}
+				out.append(std::string_view{ run, it });
+				run = it + 1;
+				out.append("\\ufffd");
+				continue;
+			}
+			if (ch >= 0x20u && ch != '"' && ch != '\\')
+				continue;
+			out.append(std::string_view{ run, it });
+			run = it + 1;
+			out.push_back('\\');
+			switch (ch) {
+			case '"': out.push_back('"'); break;
+			case '\\': out.push_back('\\'); break;
+			case '\n': out.push_back('n'); break;
+			case '\r': out.push_back('r'); break;
+			case '\t': out.push_back('t'); break;
+			default:
+				out.append("u00");
+				out.push_back(hex[ch >> 4u]);
+				out.push_back(hex[ch & 0xFu]);
+				break;
+			}
+		}
+		out.append(std::string_view{ run, str.end() });
+		out.push_back('"');
+	}
+
+	/**
+	 * @brief Append a JSON representation of a range of arguments to a buffer.
+	 *\n	  Each argument is written as an object with a "type" (PARAMETER, OPTION or FLAG) & a "name", & a "capture" when it has one:
+	 *\n	  [{"type":"FLAG","name":"a","capture":"value"},{"type":"PARAMETER","name":"file"}]
+	 * @param out	- Output buffer.
+	 * @param first	- Iterator to the first argument.
+	 * @param last	- Iterator to one past the last argument.
+	 */
+	template<class Out>
+	inline void serialize_json(Out& out, ContainerType::const_iterator first, const ContainerType::const_iterator& last)
+	{
+		out.push_back('[');
+		for (auto it{ first }; it != last; ++it) {
+			if (it != first)
+				out.push_back(',');
+			switch (it->type()) {
+			case Type::PARAMETER:
+				out.append(R"({"type":"PARAMETER","name":)");
+				break;
+			case Type::OPTION:
+				out.append(R"({"type":"OPTION","name":)");
+				break;
+			case Type::FLAG:
+				out.append(R"({"type":"FLAG","name":)");
+				break;
+			default:
+				out.append(R"({"type":"MONOSTATE","name":)");
+				break;
+			}
+			write_json_string(out, it->name_view());
+			if (const auto& cap{ it->capture() }; cap.has_value()) {
+				out.append(R"(,"capture":)");
+				write_json_string(out, cap.value());
+			}
+			out.push_back('}');
+		}
+		out.push_back(']');
+	}
+	/**
+	 * @brief Retrieve a JSON representation of an argument container.
+	 * @param cont	- Argument container.
+	 * @returns std::string
+	 */
+	inline std::string serialize_json(const ContainerType& cont)
+	{
+		std::string out;
+		serialize_json(out, cont.begin(), cont.end());
+		return out;
+	}
+	/**
+	 * @brief Write a JSON representation of an argument container directly into a caller-provided buffer.
+	 * @param buffer	- Output buffer.
+	 * @param size		- Size of the output buffer.
+	 * @param cont		- Argument container.
+	 * @returns size_t	- The number of bytes required. If this is greater than size, the output was truncated & should be written again into a larger buffer.
+	 */
+	inline size_t serialize_json(char* buffer, const size_t size, const ContainerType& cont)
+	{
+		BufferWriter out{ buffer, size };
+		serialize_json(out, cont.begin(), cont.end());
+		return out.size();
+	}
+
+	/**
+	 * @brief Convert a binary representation produced by serialize() back into an argument container, removing the consumed bytes from the input.
+	 * @param in	- Input buffer.
+	 * @returns std::optional<ContainerType>
+	 *\n		std::nullopt	- The buffer was truncated or malformed.
+	 */
+	inline std::optional<ContainerType> deserialize(std::string_view& in)
+	{
+		const auto read_string{ [&in]() -> std::optional<std::string> {
+			if (const auto len{ read_varint(in) }; len.has_value() && len.value() <= in.size()) {
+				std::string str{ in.substr(0u, len.value()) };
+				in.remove_prefix(len.value());
+				return str;
+			}
+			return std::nullopt;
+		} };
+
+		const auto count{ read_varint(in) };
+		if (!count.has_value() || count.value() > in.size()) // every argument takes at least 1 byte
+			return std::nullopt;
+		ContainerType cont;
+		cont.reserve(count.value());
+		for (uint64_t i{ 0u }; i < count.value(); ++i) {
+			if (in.empty())
+				return std::nullopt;
+			const auto tag{ static_cast<unsigned char>(in.front()) };
+			in.remove_prefix(1u);
+			auto name{ read_string() };
+			if (!name.has_value())
+				return std::nullopt;
+			std::optional<std::string> cap{ std::nullopt };
+			if ((tag & 0x4u) != 0u && !(cap = read_string()).has_value())
+				return std::nullopt;
+			switch (static_cast<Type>(tag & 0x3u)) {
+			case Type::PARAMETER:
+				cont.emplace_back(std::move(name.value()));
+				break;
+			case Type::OPTION:
+				cont.emplace_back(std::make_pair(std::move(name.value()), std::move(cap)));
+				break;
+			case Type::FLAG:
+				if (name->size() != 1u)
+					return std::nullopt;
+				cont.emplace_back(std::make_pair(name->front(), std::move(cap)));
+				break;
+			default:
+				return std::nullopt;
+			}
+		}
+		return cont;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,292 @@
+/**
+ * @file trace-phases.hpp
+ * @author radj307
+ * @brief Optional tracing of the phases of parsing, which are written as Chrome trace-event JSON into a caller-provided buffer.
+ *\n	  Define OPT_TRACE to enable the OPT_TRACE_* macros, which otherwise expand to nothing.
+ *\n	  The output can be opened with Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *\n_USAGE:_
+ *\n	char buffer[65536];
+ *\n	opt::trace::TraceBuffer trace{ buffer, sizeof(buffer) };
+ *\n	const opt::ParamsAPI args{ argc, argv };
+ *\n	const std::string_view json{ trace.finish() };
+ */
+#pragma once
+#include <OPT_PARSER_LIB.h>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <buffer-writer.hpp>
+
+namespace opt::trace {
+	/// @brief Names of the traced phases.
+	namespace phase {
+		inline constexpr std::string_view VECTORIZE{ "vectorize" };
+		inline constexpr std::string_view CLASSIFY{ "prefix classification" };
+		inline constexpr std::string_view CAPTURE{ "capture resolution" };
+		inline constexpr std::string_view SHRINK{ "container shrink" };
+		inline constexpr std::string_view INDEX{ "index build" };
+		inline constexpr std::string_view ENVIRONMENT{ "environment parse" };
+		inline constexpr std::string_view PATH{ "path resolution" };
+	}
+
+	/**
+	 * @brief Retrieve the number of nanoseconds since an arbitrary, fixed point in time.
+	 * @returns int64_t
+	 */
+	inline int64_t now() noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * @brief Retrieve a small number that identifies the calling thread in trace output. Numbers are assigned in the order that threads are first traced.
+	 * @returns uint32_t
+	 */
+	inline uint32_t thread_number() noexcept
+	{
+		static std::atomic<uint32_t> next{ 1u };
+		thread_local const uint32_t number{ next.fetch_add(1u, std::memory_order_relaxed) };
+		return number;
+	}
+
+	/**
+	 * @class TraceBuffer
+	 * @brief Receives trace events from every thread while it exists, & writes them into a caller-provided buffer as a Chrome trace-event JSON array.
+	 *\n	  Only one TraceBuffer receives events at a time; constructing a new one replaces the current one until the new one is finished.
+	 *\n	  Buffers may be finished in any order, & finishing a buffer waits for events that other threads are still writing to it.
+	 *\n	  Events that don't fit in the buffer are discarded, but size() still returns the number of bytes required to hold all of them.
+	 */
+	class TraceBuffer {
+		static inline std::mutex _registry;							///< @brief Guards _active, the links between buffers, & their user counts.
+		static inline std::atomic<TraceBuffer*> _active{ nullptr };	///< @brief Most recently created buffer that hasn't been finished. This is atomic so that it can be checked without locking.
+
+		TraceBuffer* _previous{ nullptr };	///< @brief Next older buffer that hasn't been finished, which becomes active again if this one is finished first.
+		TraceBuffer* _next{ nullptr };		///< @brief Next newer buffer that hasn't been finished.
+		bool _linked{ true };				///< @brief True until this buffer is removed from the list of unfinished buffers.
+		size_t _users{ 0u };				///< @brief Number of threads that are writing an event through complete_active().
+		std::condition_variable _released;	///< @brief Notified when _users drops to 0.
+		std::mutex _mutex;
+		BufferWriter _out;
+		int64_t _origin;			///< @brief Timestamps are written relative to this time, which is when the buffer was created.
+		bool _empty{ true };		///< @brief True when no events have been written yet.
+		bool _finished{ false };	///< @brief True when finish() has been called.
+
+		template<class T>
+		void write_number(const T value)
+		{
+			char buf[24];
+			const auto [end, ec] { std::to_chars(buf, buf + sizeof(buf), value) };
+			_out.append(std::string_view{ buf, static_cast<size_t>(end - buf) });
+		}
+		/// @brief Write a duration in nanoseconds as microseconds, the unit used by the trace-event format.
+		void write_micros(const int64_t ns)
+		{
+			write_number(ns / 1000);
+			_out.push_back('.');
+			const auto frac{ static_cast<int>(ns % 1000) };
+			_out.push_back(static_cast<char>('0' + frac / 100));
+			_out.push_back(static_cast<char>('0' + frac / 10 % 10));
+			_out.push_back(static_cast<char>('0' + frac % 10));
+		}
+
+	public:
+		/**
+		 * @brief Constructor. Begins receiving trace events.
+		 * @param buffer	- Start of the buffer. May be nullptr if capacity is 0, which only measures the output.
+		 * @param capacity	- Size of the buffer.
+		 */
+		TraceBuffer(char* buffer, const size_t capacity) : _out{ buffer, capacity }, _origin{ now() }
+		{
+			_out.push_back('[');
+			std::scoped_lock lock{ _registry };
+			_previous = _active.load(std::memory_order_relaxed);
+			if (_previous != nullptr)
+				_previous->_next = this;
+			_active.store(this, std::memory_order_release);
+		}
+		TraceBuffer(const TraceBuffer&) = delete;
+		TraceBuffer& operator=(const TraceBuffer&) = delete;
+		~TraceBuffer() { finish(); }
+
+		/**
+		 * @brief Retrieve the TraceBuffer that is currently receiving events.
+		 * @returns TraceBuffer*	- nullptr if tracing isn't active.
+		 */
+		static TraceBuffer* active() noexcept { return _active.load(std::memory_order_acquire); }
+
+		/**
+		 * @brief Write a complete event to the active TraceBuffer, if there is one. That buffer can't be finished or destroyed until the event has been written,
+		 *\n	  so this is safe to call from any thread.
+		 * @param name	- Name of the event. This must not contain characters that need to be escaped in JSON.
+		 * @param start	- Start time, as returned by now().
+		 * @param end	- End time, as returned by now().
+		 * @param count	- When non-zero, the event aggregates this many separate intervals, which is recorded in its args.
+		 */
+		static void complete_active(const std::string_view name, const int64_t start, const int64_t end, const uint64_t count = 0u)
+		{
+			if (active() == nullptr)
+				return;
+			TraceBuffer* buffer;
+			{
+				std::scoped_lock lock{ _registry };
+				if (buffer = _active.load(std::memory_order_relaxed); buffer == nullptr)
+					return;
+				++buffer->_users;
+			}
+			buffer->complete(name, start, end, count);
+			std::scoped_lock lock{ _registry };
+			if (--buffer->_users == 0u)
+				buffer->_released.notify_all();
+		}
+
+		/**
+		 * @brief Write a complete event. ("ph":"X")
+		 * @param name	- Name of the event. This must not contain characters that need to be escaped in JSON.
+		 * @param start	- Start time, as returned by now().
+		 * @param end	- End time, as returned by now().
+		 * @param count	- When non-zero, the event aggregates this many separate intervals, which is recorded in its args.
+		 */
+		void complete(const std::string_view name, const int64_t start, const int64_t end, const uint64_t count = 0u)
+		{
+			const auto tid{ thread_number() };
+			std::scoped_lock lock{ _mutex };
+			if (_finished)
+				return;
+			if (!_empty)
+				_out.push_back(',');
+			_empty = false;
+			_out.append("{\"name\":\"");
+			_out.append(name);
+			_out.append("\",\"cat\":\"opt\",\"ph\":\"X\",\"ts\":");
+			write_micros(start - _origin);
+			_out.append(",\"dur\":");
+			write_micros(end - start);
+			_out.append(",\"pid\":1,\"tid\":");
+			write_number(tid);
+			if (count != 0u) {
+				_out.append(",\"args\":{\"count\":");
+				write_number(count);
+				_out.push_back('}');
+			}
+			_out.push_back('}');
+		}
+
+		/**
+		 * @brief Stop receiving events & close the JSON array. Calling this more than once has no effect.
+		 * @returns std::string_view	- The JSON that was written to the buffer.
+		 */
+		std::string_view finish()
+		{
+			{
+				std::unique_lock lock{ _registry };
+				if (_linked) {
+					// unlink this buffer, so that newer buffers fall back to the right one no matter which order they are finished in
+					if (_next != nullptr)
+						_next->_previous = _previous;
+					else
+						_active.store(_previous, std::memory_order_release);
+					if (_previous != nullptr)
+						_previous->_next = _next;
+					_linked = false;
+				}
+				// no thread can start using this buffer after it is unlinked, so wait for the ones that already are
+				_released.wait(lock, [this]() { return _users == 0u; });
+			}
+			std::scoped_lock lock{ _mutex };
+			if (!_finished) {
+				_finished = true;
+				_out.push_back(']');
+			}
+			return _out.view();
+		}
+
+		[[nodiscard]] size_t size() const noexcept { return _out.size(); }				///< @brief Retrieve the number of bytes required to hold every event.	@returns size_t
+		[[nodiscard]] bool overflowed() const noexcept { return _out.overflowed(); }	///< @brief Check if any events were discarded.						@returns bool
+	};
+
+	/**
+	 * @class Phase
+	 * @brief RAII object that writes a complete event covering its lifetime to the active TraceBuffer.
+	 */
+	class Phase {
+		std::string_view _name;
+		int64_t _start;
+
+	public:
+		/**
+		 * @brief Constructor.
+		 * @param name	- Name of the phase.
+		 */
+		explicit Phase(const std::string_view name) noexcept : _name{ name }, _start{ TraceBuffer::active() == nullptr ? 0 : now() } {}
+		Phase(const Phase&) = delete;
+		Phase& operator=(const Phase&) = delete;
+		~Phase()
+		{
+			if (_start != 0)
+				TraceBuffer::complete_active(_name, _start, now());
+		}
+	};
+
+	/**
+	 * @class AggregatePhase
+	 * @brief Sums the durations of many short intervals that are interleaved with other work, & writes them as a single event when destroyed.
+	 *\n	  The event begins when the AggregatePhase was created & lasts for the total duration, with the number of intervals in its args.
+	 */
+	class AggregatePhase {
+		std::string_view _name;
+		int64_t _start, _total{ 0 };
+		uint64_t _count{ 0u };
+
+	public:
+		/**
+		 * @class Interval
+		 * @brief RAII object that adds its lifetime to an AggregatePhase.
+		 */
+		class Interval {
+			AggregatePhase& _owner;
+			int64_t _start;
+
+		public:
+			explicit Interval(AggregatePhase& owner) noexcept : _owner{ owner }, _start{ owner._start == 0 ? 0 : now() } {}
+			Interval(const Interval&) = delete;
+			Interval& operator=(const Interval&) = delete;
+			~Interval()
+			{
+				if (_start != 0) {
+					_owner._total += now() - _start;
+					++_owner._count;
+				}
+			}
+		};
+
+		/**
+		 * @brief Constructor.
+		 * @param name	- Name of the phase.
+		 */
+		explicit AggregatePhase(const std::string_view name) noexcept : _name{ name }, _start{ TraceBuffer::active() == nullptr ? 0 : now() } {}
+		AggregatePhase(const AggregatePhase&) = delete;
+		AggregatePhase& operator=(const AggregatePhase&) = delete;
+		~AggregatePhase()
+		{
+			if (_count != 0u)
+				TraceBuffer::complete_active(_name, _start, _start + _total, _count);
+		}
+	};
+}
+
+#ifdef OPT_TRACE
+/// @brief Trace the rest of the enclosing block as a phase with the given name.
+#define OPT_TRACE_PHASE(name) const ::opt::trace::Phase _opt_trace_phase{ name }
+/// @brief Declare an AggregatePhase variable, which is written to the trace at the end of the enclosing block.
+#define OPT_TRACE_AGGREGATE(var, name) ::opt::trace::AggregatePhase var{ name }
+/// @brief Add the rest of the enclosing block to an AggregatePhase variable.
+#define OPT_TRACE_INTERVAL(var) const ::opt::trace::AggregatePhase::Interval _opt_trace_interval{ var }
+#else
+#define OPT_TRACE_PHASE(name)
+#define OPT_TRACE_AGGREGATE(var, name)
+#define OPT_TRACE_INTERVAL(var)
+#endif
\ No newline at end of file
@@ -5,6 +5,8 @@
  */
 #pragma once
 #include <OPT_PARSER_LIB.h>
+#include <instrument-allocations.hpp>
+#include <trace-phases.hpp>
 #include <vector>
 #include <string>
 
@@ -17,6 +19,8 @@ namespace opt {
 	 */
 	inline std::vector<std::string> vectorize(const int size, char** arr, const int off = 1)
 	{
+		OPT_INSTRUMENT_SCOPE(VECTORIZE);
+		OPT_TRACE_PHASE(trace::phase::VECTORIZE);
 		std::vector<std::string> vec;
 		vec.reserve(size); // reserve some space
 		for (auto i{ off }; i < size; ++i)